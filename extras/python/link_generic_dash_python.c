@@ -0,0 +1,231 @@
+/*
+ link_generic_dash_python.c - CPython / NumPy bindings for the batch decoder
+ For copyright and license information see LICENSE
+
+ Decodes recorded frames straight into NumPy arrays with decodeGenericDashBatch,
+ or decodeGenericDashFleet when more than one thread is asked for. Records are
+ read in place from anything supporting the buffer protocol, ie. a NumPy array
+ of RECORD_DTYPE, bytes or an mmap, and values are written directly into the
+ returned array so nothing is copied on the way in or out.
+
+ Build with "pip install ." from this directory, see setup.py.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+#define NPY_NO_DEPRECATED_API NPY_1_7_API_VERSION
+#include <numpy/arrayobject.h>
+
+#include "link_generic_dash.h"
+#include "link_generic_dash_batch.h"
+#include "link_generic_dash_fleet.h"
+
+/*
+ Gets a read only view of a records buffer, the returned memoryview keeps it alive
+ */
+static PyObject* getGenericDashPythonRecords(PyObject* records, const GenericDashRecord** data, size_t* count) {
+	PyObject* view = PyMemoryView_FromObject(records);
+	if (view == NULL) return NULL;
+
+	Py_buffer* buffer = PyMemoryView_GET_BUFFER(view);
+	if (!PyBuffer_IsContiguous(buffer, 'C')) {
+		PyErr_SetString(PyExc_ValueError, "records must be contiguous");
+	} else if (buffer->len % sizeof(GenericDashRecord) != 0) {
+		PyErr_Format(PyExc_ValueError, "records must be a multiple of %d bytes", (int)sizeof(GenericDashRecord));
+	} else if ((uintptr_t)buffer->buf % _Alignof(GenericDashRecord) != 0) {
+		PyErr_Format(PyExc_ValueError, "records must be aligned to %d bytes", (int)_Alignof(GenericDashRecord));
+	} else {
+		*data = (const GenericDashRecord*)buffer->buf;
+		*count = (size_t)buffer->len / sizeof(GenericDashRecord);
+		return view;
+	}
+	Py_DECREF(view);
+	return NULL;
+}
+
+static PyObject* decodeGenericDashPython(PyObject* self, PyObject* args, PyObject* kwargs) {
+	static char* keywords[] = { "records", "scaled", "parameters", "threads", NULL };
+	PyObject* records;
+	int scaled = 1;
+	PyObject* parameters = Py_None;
+	unsigned int threads = 1;
+	(void)self;
+
+	if (!PyArg_ParseTupleAndKeywords(args, kwargs, "O|pOI", keywords, &records, &scaled, &parameters, &threads)) return NULL;
+
+	// Which parameters to decode and which row of the output each one goes in
+	int selected[Generic_Dash_Parameter_Count];
+	npy_intp rows = 0;
+	if (parameters == Py_None) {
+		for (int i = 0; i < Generic_Dash_Parameter_Count; i++) selected[rows++] = i;
+	} else {
+		PyObject* sequence = PySequence_Fast(parameters, "parameters must be a sequence of parameter numbers");
+		if (sequence == NULL) return NULL;
+		uint64_t requested = 0;
+		Py_ssize_t length = PySequence_Fast_GET_SIZE(sequence);
+		for (Py_ssize_t i = 0; i < length; i++) {
+			long param = PyLong_AsLong(PySequence_Fast_GET_ITEM(sequence, i));
+			if (param == -1 && PyErr_Occurred()) {
+				Py_DECREF(sequence);
+				return NULL;
+			}
+			if (param < 0 || param >= Generic_Dash_Parameter_Count || rows >= Generic_Dash_Parameter_Count) {
+				Py_DECREF(sequence);
+				PyErr_Format(PyExc_ValueError, "parameters must be up to %d numbers from 0 to %d", Generic_Dash_Parameter_Count, Generic_Dash_Parameter_Count - 1);
+				return NULL;
+			}
+			// Each parameter has one output column in the stream, so a second row for it would never be filled in
+			if (requested & ((uint64_t)1 << param)) {
+				Py_DECREF(sequence);
+				PyErr_Format(PyExc_ValueError, "parameter %ld is listed more than once", param);
+				return NULL;
+			}
+			requested |= (uint64_t)1 << param;
+			selected[rows++] = (int)param;
+		}
+		Py_DECREF(sequence);
+	}
+
+	const GenericDashRecord* data;
+	size_t count;
+	PyObject* view = getGenericDashPythonRecords(records, &data, &count);
+	if (view == NULL) return NULL;
+
+	npy_intp dims[2] = { rows, (npy_intp)count };
+	PyArrayObject* output = (PyArrayObject*)PyArray_SimpleNew(2, dims, scaled ? NPY_FLOAT32 : NPY_UINT16);
+	if (output == NULL) {
+		Py_DECREF(view);
+		return NULL;
+	}
+
+	// Each row of the output is one parameter's column
+	GenericDashFleetStream stream;
+	memset(&stream, 0, sizeof(stream));
+	stream.records = data;
+	stream.recordCount = count;
+	for (npy_intp i = 0; i < rows; i++) {
+		if (scaled) stream.columns[selected[i]] = (float*)PyArray_GETPTR2(output, i, 0);
+		else stream.rawColumns[selected[i]] = (uint16_t*)PyArray_GETPTR2(output, i, 0);
+	}
+
+	bool decoded = true;
+	Py_BEGIN_ALLOW_THREADS
+#ifdef GENERIC_DASH_FLEET_DECODER
+	if (threads != 1) {
+		decoded = decodeGenericDashFleet(&stream, 1, threads, 0);
+	} else
+#endif
+	{
+		GenericDashContext context;
+		initGenericDashContext(&context);
+		stream.acceptedFrames = decodeGenericDashBatch(&context, data, count, stream.rawColumns, stream.columns);
+	}
+	Py_END_ALLOW_THREADS
+
+	Py_DECREF(view);
+	if (!decoded) {
+		Py_DECREF(output);
+		return PyErr_NoMemory();
+	}
+	return (PyObject*)output;
+}
+
+static PyObject* getGenericDashPythonTimestamps(PyObject* self, PyObject* records) {
+	const GenericDashRecord* data;
+	size_t count;
+	(void)self;
+
+	PyObject* view = getGenericDashPythonRecords(records, &data, &count);
+	if (view == NULL) return NULL;
+
+	// A strided view of the timestamps inside the records, which it keeps alive
+	npy_intp dims[1] = { (npy_intp)count };
+	npy_intp strides[1] = { sizeof(GenericDashRecord) };
+	PyObject* timestamps = PyArray_New(&PyArray_Type, 1, dims, NPY_UINT64, strides, (void*)&data->timestamp, 0, 0, NULL);
+	if (timestamps == NULL || PyArray_SetBaseObject((PyArrayObject*)timestamps, view) < 0) {
+		Py_XDECREF(timestamps);
+		Py_DECREF(view);
+		return NULL;
+	}
+	return timestamps;
+}
+
+static PyObject* findGenericDashPythonParameter(PyObject* self, PyObject* name) {
+	(void)self;
+	const char* text = PyUnicode_AsUTF8(name);
+	if (text == NULL) return NULL;
+
+	GenericDashParameters param;
+	if (!findGenericDashParameter(text, &param)) {
+		PyErr_Format(PyExc_KeyError, "unknown parameter %R", name);
+		return NULL;
+	}
+	return PyLong_FromLong(param);
+}
+
+static PyMethodDef GenericDashPythonMethods[] = {
+	{ "decode", (PyCFunction)(void (*)(void))decodeGenericDashPython, METH_VARARGS | METH_KEYWORDS,
+		"decode(records, scaled=True, parameters=None, threads=1)\n--\n\n"
+		"Decodes records into one row per parameter and one column per record, holding\n"
+		"each value until it is next updated. Scaled values are float32, raw values\n"
+		"uint16. parameters limits which parameters are decoded and in what order,\n"
+		"each listed at most once. threads other than 1 decodes across that many\n"
+		"threads, 0 for one per CPU." },
+	{ "timestamps", getGenericDashPythonTimestamps, METH_O,
+		"timestamps(records)\n--\n\n"
+		"Returns the timestamp of every record in microseconds, as a view of records." },
+	{ "parameter", findGenericDashPythonParameter, METH_O,
+		"parameter(name)\n--\n\n"
+		"Returns the number of a parameter given its name or short ID, ie. \"RPM\"." },
+	{ NULL, NULL, 0, NULL }
+};
+
+static struct PyModuleDef GenericDashPythonModule = {
+	PyModuleDef_HEAD_INIT, "link_generic_dash", "Link ECU Generic Dash batch decoder", -1, GenericDashPythonMethods,
+	NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit_link_generic_dash(void) {
+	import_array();
+
+	PyObject* module = PyModule_Create(&GenericDashPythonModule);
+	if (module == NULL) return NULL;
+
+	// Names and units of each parameter, in the order rows are returned by decode
+	PyObject* names = PyTuple_New(Generic_Dash_Parameter_Count);
+	PyObject* units = PyTuple_New(Generic_Dash_Parameter_Count);
+	if (names == NULL || units == NULL) goto failed;
+	for (int i = 0; i < Generic_Dash_Parameter_Count; i++) {
+		char text[maxGenericDashParameterNameLength];
+		getGenericDashParameterName((GenericDashParameters)i, text);
+		PyTuple_SET_ITEM(names, i, PyUnicode_FromString(text));
+		text[0] = 0;
+		getGenericDashParameterUom((GenericDashParameters)i, text);
+		PyTuple_SET_ITEM(units, i, PyUnicode_FromString(text));
+	}
+	if (PyModule_AddObject(module, "PARAMETER_NAMES", names) < 0) goto failed;
+	names = NULL;
+	if (PyModule_AddObject(module, "PARAMETER_UNITS", units) < 0) goto failed;
+	units = NULL;
+
+	// Matches GenericDashRecord, for numpy.fromfile or building records yourself
+	PyObject* dtype = Py_BuildValue("[(s,s),(s,s,i)]", "timestamp", "u8", "frame", "u1", 8);
+	PyArray_Descr* descr = NULL;
+	if (dtype == NULL || !PyArray_DescrConverter(dtype, &descr)) {
+		Py_XDECREF(dtype);
+		goto failed;
+	}
+	Py_DECREF(dtype);
+	if (PyModule_AddObject(module, "RECORD_DTYPE", (PyObject*)descr) < 0) {
+		Py_DECREF(descr);
+		goto failed;
+	}
+	if (PyModule_AddIntConstant(module, "PARAMETER_COUNT", Generic_Dash_Parameter_Count) < 0) goto failed;
+	return module;
+
+failed:
+	Py_XDECREF(names);
+	Py_XDECREF(units);
+	Py_DECREF(module);
+	return NULL;
+}
@@ -0,0 +1,32 @@
+"""
+ setup.py - Builds the link_generic_dash Python module
+ For copyright and license information see LICENSE
+
+ From this directory run:
+  pip install .
+"""
+
+import os
+import sys
+
+import numpy
+from setuptools import Extension, setup
+
+root = os.path.join("..", "..")
+sources = ["link_generic_dash.c", "link_generic_dash_batch.c", "link_generic_dash_fleet.c"]
+
+setup(
+    name="link_generic_dash",
+    version="1.0.0",
+    description="Link ECU Generic Dash batch decoder",
+    license="MIT",
+    ext_modules=[
+        Extension(
+            "link_generic_dash",
+            sources=["link_generic_dash_python.c"] + [os.path.join(root, source) for source in sources],
+            include_dirs=[root, numpy.get_include()],
+            extra_compile_args=["-O3"] if sys.platform != "win32" else ["/O2"],
+            libraries=["pthread"] if sys.platform != "win32" else [],
+        )
+    ],
+)
@@ -0,0 +1,52 @@
+"""
+ test_link_generic_dash.py - Tests for the link_generic_dash Python module
+ For copyright and license information see LICENSE
+
+ Once the module is installed, from this directory run:
+  python -m unittest test_link_generic_dash
+"""
+
+import unittest
+
+import numpy as np
+
+import link_generic_dash as ld
+
+
+def make_records(frames):
+    """Builds records from (timestamp, frame index, three raw words) tuples"""
+    records = np.zeros(len(frames), dtype=ld.RECORD_DTYPE)
+    for i, (timestamp, index, words) in enumerate(frames):
+        records["timestamp"][i] = timestamp
+        records["frame"][i, 0] = index
+        records["frame"][i, 2:] = np.array(words, dtype="<u2").view(np.uint8)
+    return records
+
+
+class DecodeParametersTest(unittest.TestCase):
+    def setUp(self):
+        self.records = make_records([(1000, 0, (800, 90, 100)), (2000, 0, (900, 95, 100)), (3000, 1, (1, 2, 3))])
+
+    def test_selected_parameters_match_full_decode(self):
+        everything = ld.decode(self.records, scaled=False)
+        selected = ld.decode(self.records, scaled=False, parameters=[4, 0, 1])
+        self.assertEqual(selected.shape, (3, len(self.records)))
+        np.testing.assert_array_equal(selected, everything[[4, 0, 1]])
+
+    def test_duplicate_parameters_are_rejected(self):
+        for scaled in (True, False):
+            with self.assertRaises(ValueError):
+                ld.decode(self.records, scaled=scaled, parameters=[0, 1, 0])
+
+    def test_out_of_range_parameters_are_rejected(self):
+        for parameters in ([-1], [ld.PARAMETER_COUNT], [0, ld.PARAMETER_COUNT + 10]):
+            with self.assertRaises(ValueError):
+                ld.decode(self.records, parameters=parameters)
+
+    def test_too_many_parameters_are_rejected(self):
+        with self.assertRaises(ValueError):
+            ld.decode(self.records, parameters=list(range(ld.PARAMETER_COUNT)) + [0])
+
+
+if __name__ == "__main__":
+    unittest.main()
@@ -0,0 +1,72 @@
+/*
+ test_link_generic_dash_fleet.c - Tests for multi-threaded fleet decoding
+ For copyright and license information see LICENSE
+
+ From the root of the library compile and run this with something like:
+  gcc -I. link_generic_dash.c link_generic_dash_batch.c link_generic_dash_fleet.c extras/tests/test_link_generic_dash_fleet.c -lpthread -o test_fleet
+  ./test_fleet
+
+ Prints each failed check and exits non-zero if any failed.
+ */
+
+#include "link_generic_dash_fleet.h"
+#include <stdio.h>
+
+#define testGenericDashFleetRecords 4000
+
+static int failures = 0;
+
+#define checkGenericDashFleet(condition, text) \
+	do { \
+		if (!(condition)) { \
+			printf("FAILED %s: %s\n", #condition, text); \
+			failures++; \
+		} \
+	} while (0)
+
+static GenericDashRecord records[testGenericDashFleetRecords];
+static uint16_t rawColumns[Generic_Dash_Parameter_Count][testGenericDashFleetRecords];
+
+/*
+ Decodes records with the given threads and chunk size and checks every raw
+ word against decoding them one at a time in order
+ */
+static void checkGenericDashFleetMatchesInOrder(unsigned int threadCount, size_t chunkRecords, const char* text) {
+	GenericDashFleetStream stream;
+	memset(&stream, 0, sizeof(stream));
+	stream.records = records;
+	stream.recordCount = testGenericDashFleetRecords;
+	for (int p = 0; p < Generic_Dash_Parameter_Count; p++) stream.rawColumns[p] = rawColumns[p];
+	checkGenericDashFleet(decodeGenericDashFleet(&stream, 1, threadCount, chunkRecords), text);
+
+	GenericDashContext context;
+	initGenericDashContext(&context);
+	size_t mismatches = 0;
+	for (size_t i = 0; i < testGenericDashFleetRecords; i++) {
+		parseGenericDashContextCanFrame(&context, records[i].frame);
+		for (int p = 0; p < Generic_Dash_Parameter_Count; p++) mismatches += rawColumns[p][i] != context.words[p];
+	}
+	checkGenericDashFleet(mismatches == 0, text);
+}
+
+static void testGenericDashFleetQuietFrame(void) {
+	// Frame 5 goes quiet after the first ten cycles, long before the later chunks start
+	for (size_t i = 0; i < testGenericDashFleetRecords; i++) {
+		unsigned char index = i % Generic_Dash_Frame_Count;
+		if (index == 5 && i > 140) index = 6;
+		records[i].timestamp = i;
+		records[i].frame[0] = index;
+		records[i].frame[2] = i & 0xFF;
+		records[i].frame[3] = i >> 8;
+		records[i].frame[4] = i * 7;
+	}
+	checkGenericDashFleetMatchesInOrder(4, 1000, "4 threads, 1000 record chunks");
+	checkGenericDashFleetMatchesInOrder(3, 7, "3 threads, 7 record chunks");
+	checkGenericDashFleetMatchesInOrder(1, 0, "1 thread, default chunks");
+}
+
+int main(void) {
+	testGenericDashFleetQuietFrame();
+	if (failures == 0) printf("All fleet tests passed\n");
+	return failures != 0;
+}
@@ -0,0 +1,89 @@
+/*
+ test_link_generic_dash_import.c - Tests for the candump and Vector ASC importer
+ For copyright and license information see LICENSE
+
+ From the root of the library compile and run this with something like:
+  gcc -I. link_generic_dash.c link_generic_dash_import.c extras/tests/test_link_generic_dash_import.c -lpthread -o test_import
+  ./test_import
+
+ Prints each failed check and exits non-zero if any failed.
+ */
+
+#include "link_generic_dash_import.h"
+#include <stdio.h>
+
+static int failures = 0;
+
+#define checkGenericDashImport(condition, text) \
+	do { \
+		if (!(condition)) { \
+			printf("FAILED %s: %s\n", #condition, text); \
+			failures++; \
+		} \
+	} while (0)
+
+/*
+ Imports text on its own as a whole log
+ */
+static GenericDashImporter importGenericDashTestText(const char* text, unsigned int canId) {
+	GenericDashImporter importer;
+	initGenericDashImporter(&importer, IMPORT_FORMAT_AUTO, canId, NULL, NULL);
+	importGenericDashText(&importer, text, strlen(text), true);
+	return importer;
+}
+
+static bool keepGenericDashTestTimestamp(GenericDashImporter* importer, const GenericDashRecord* records, size_t count) {
+	*(uint64_t*)importer->user = records[count - 1].timestamp;
+	return true;
+}
+
+static void testGenericDashImportMalformedCandumpTimestamps(void) {
+	// Each of these used to skip from a NULL pointer, with and without a newline after
+	static const char* lines[] = {
+		"(abc) can0 3E8#0000E8030000FA00",
+		"() can0 3E8#0000E8030000FA00",
+		"(14365x9052.249713) can0 3E8#0000E8030000FA00",
+		"(abc) can0 3E8#0000E8030000FA00\n",
+		"(",
+	};
+	for (size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); i++) {
+		GenericDashImporter importer = importGenericDashTestText(lines[i], defaultGenericDashCanId);
+		checkGenericDashImport(importer.records == 0 && importer.skippedLines == 1, lines[i]);
+	}
+
+	// A corrupt line doesn't stop the ones after it being imported
+	const char* log = "(abc) can0 3E8#0000E8030000FA00\n(1436509052.249713) can0 3E8#0000E8030000FA00\n";
+	GenericDashImporter importer = importGenericDashTestText(log, defaultGenericDashCanId);
+	checkGenericDashImport(importer.records == 1 && importer.skippedLines == 1, log);
+}
+
+static void testGenericDashImportTimestampDigits(void) {
+	// Punctuation just below '0' and just above '9' isn't a digit, on either timestamp path
+	static const char* lines[] = {
+		"(14365/9052.249713) can0 3E8#0000E8030000FA00",
+		"(1436509052.24-713) can0 3E8#0000E8030000FA00",
+		"(143650905*.249713) can0 3E8#0000E8030000FA00",
+		"(1436509052.24971:) can0 3E8#0000E8030000FA00",
+		"(1436509052.2497?3) can0 3E8#0000E8030000FA00",
+	};
+	for (size_t i = 0; i < sizeof(lines) / sizeof(lines[0]); i++) {
+		GenericDashImporter importer = importGenericDashTestText(lines[i], defaultGenericDashCanId);
+		checkGenericDashImport(importer.records == 0 && importer.skippedLines == 1, lines[i]);
+	}
+
+	uint64_t timestamp = 0;
+	const char* line = "(1436509052.249713) can0 3E8#0000E8030000FA00";
+	GenericDashImporter importer;
+	initGenericDashImporter(&importer, IMPORT_FORMAT_AUTO, defaultGenericDashCanId, NULL, NULL);
+	importer.callback = keepGenericDashTestTimestamp;
+	importer.user = &timestamp;
+	importGenericDashText(&importer, line, strlen(line), true);
+	checkGenericDashImport(importer.records == 1 && timestamp == 1436509052249713ULL, line);
+}
+
+int main(void) {
+	testGenericDashImportMalformedCandumpTimestamps();
+	testGenericDashImportTimestampDigits();
+	if (failures == 0) printf("All import tests passed\n");
+	return failures != 0;
+}
@@ -5,143 +5,184 @@
 
 #include "link_generic_dash.h"
 
-#define GenericDashFrames 14
-#define GenericDashBytes 8
-unsigned char GenericDash[GenericDashFrames][GenericDashBytes];
+#define GenericDashFrames Generic_Dash_Frame_Count
+#define GenericDashWordsPerFrame 3
+GenericDashContext GenericDash;
 
-bool parseGenericDashCanFrame(unsigned char frame[8]) {
+void initGenericDashContext(GenericDashContext* context) {
+	memset(context, 0, sizeof(*context));
+}
+
+bool parseGenericDashContextCanFrame(GenericDashContext* context, const unsigned char frame[8]) {
 	if ((frame[0] >= GenericDashFrames) || (frame[1] != 0)) return false;
-	for (int i = 0; i < sizeof(GenericDash[0]); i++) GenericDash[frame[0]][i] = frame[i];
+	uint16_t* words = &context->words[frame[0] * GenericDashWordsPerFrame];
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+	// Payload is already three little-endian words, memcpy keeps it safe for unaligned frames
+	memcpy(words, &frame[2], GenericDashWordsPerFrame * sizeof(uint16_t));
+#else
+	for (int i = 0; i < GenericDashWordsPerFrame; i++)
+		words[i] = (uint16_t)((frame[3 + i * 2] << 8) | frame[2 + i * 2]);
+#endif
 	return true;
 }
 
-float getGenericDashValue(GenericDashParameters param) {
+bool encodeGenericDashContextCanFrame(const GenericDashContext* context, unsigned char index, unsigned char frame[8]) {
+	if (index >= GenericDashFrames) return false;
+	const uint16_t* words = &context->words[index * GenericDashWordsPerFrame];
+	frame[0] = index;
+	frame[1] = 0;
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+	memcpy(&frame[2], words, GenericDashWordsPerFrame * sizeof(uint16_t));
+#else
+	for (int i = 0; i < GenericDashWordsPerFrame; i++) {
+		frame[2 + i * 2] = (unsigned char)(words[i] & 0xFF);
+		frame[3 + i * 2] = (unsigned char)(words[i] >> 8);
+	}
+#endif
+	return true;
+}
+
+bool parseGenericDashCanFrame(unsigned char frame[8]) {
+	return parseGenericDashContextCanFrame(&GenericDash, frame);
+}
+
+uint16_t getGenericDashContextRawValue(const GenericDashContext* context, GenericDashParameters param) {
+	if ((int)param < 0 || (int)param >= Generic_Dash_Parameter_Count) return 0;
+	return context->words[param];
+}
+
+uint16_t getGenericDashRawValue(GenericDashParameters param) {
+	return getGenericDashContextRawValue(&GenericDash, param);
+}
+
+float decodeGenericDashValue(GenericDashParameters param, uint16_t rawValue) {
+	unsigned int raw = rawValue;
 	switch (param) {
 		case ECU_ENGINE_SPEED_RPM:
-			return (signed int)((GenericDash[0][3] << 8) + (GenericDash[0][2] << 0));
+			return (signed int)raw;
 			break;
 		case ECU_MAP_KPA:
-			return (signed int)((GenericDash[0][5] << 8) + (GenericDash[0][4] << 0));
+			return (signed int)raw;
 			break;
 		case ECU_MGP_KPA:
-			return (signed int)((GenericDash[0][7] << 8) + (GenericDash[0][6] << 0)) - 100;
+			return (signed int)raw - 100;
 			break;
 		case ECU_BAROMETRIC_PRESSURE_KPA:
-			return (signed int)((GenericDash[1][3] << 8) + (GenericDash[1][2] << 0)) * 0.1;
+			return (signed int)raw * 0.1;
 			break;
 		case ECU_THROTTLE_POSITION_PERCENT:
-			return (signed int)((GenericDash[1][5] << 8) + (GenericDash[1][4] << 0)) * 0.1;
+			return (signed int)raw * 0.1;
 			break;
 		case ECU_INJECTOR_DUTY_CYCLE_PERCENT:
-			return (signed int)((GenericDash[1][7] << 8) + (GenericDash[1][6] << 0)) * 0.1;
+			return (signed int)raw * 0.1;
 			break;
 		case ECU_SECOND_STAGE_INJECTOR_DUTY_CYCLE_PERCENT:
-			return (signed int)((GenericDash[2][3] << 8) + (GenericDash[2][2] << 0)) * 0.1;
+			return (signed int)raw * 0.1;
 			break;
 		case ECU_INJECTOR_PULSE_WIDTH_MS:
-			return (signed int)((GenericDash[2][5] << 8) + (GenericDash[2][4] << 0)) * 0.001;
+			return (signed int)raw * 0.001;
 			break;
 		case ECU_ENGINE_COOLANT_TEMPERATURE_DEGREES_C:
-			return (signed int)((GenericDash[2][7] << 8) + (GenericDash[2][6] << 0)) - 50;
+			return (signed int)raw - 50;
 			break;
 		case ECU_INTAKE_AIR_TEMPERATURE_DEGRESS_C:
-			return (signed int)((GenericDash[3][3] << 8) + (GenericDash[3][2] << 0)) - 50;
+			return (signed int)raw - 50;
 			break;
 		case ECU_BATTERY_VOLTAGE:
-			return (signed int)((GenericDash[3][5] << 8) + (GenericDash[3][4] << 0)) * 0.01;
+			return (signed int)raw * 0.01;
 			break;
 		case ECU_MASS_AIR_FLOW_GRAMS_PER_SECOND:
-			return (signed int)((GenericDash[3][7] << 8) + (GenericDash[3][6] << 0)) * 0.1;
+			return (signed int)raw * 0.1;
 			break;
 		case ECU_GEAR_POSITION:
-			return (signed int)((GenericDash[4][3] << 8) + (GenericDash[4][2] << 0));
+			return (signed int)raw;
 			break;
 		case ECU_INJECTOR_TIMING_DEGREES:
-			return (signed int)((GenericDash[4][5] << 8) + (GenericDash[4][4] << 0));
+			return (signed int)raw;
 			break;
 		case ECU_IGNITION_TIMING_DEGREES:
-			return (signed int)(((GenericDash[4][7] << 8) + (GenericDash[4][6] << 0)) * 0.1) - 100;
+			return (signed int)(raw * 0.1) - 100;
 			break;
 		case ECU_CAM_INLET_POSITION_L_DEGREES:
-			return (signed int)((GenericDash[5][3] << 8) + (GenericDash[5][2] << 0)) * 0.1;
+			return (signed int)raw * 0.1;
 			break;
 		case ECU_CAM_INLET_POSITION_R_DEGREES:
-			return (signed int)((GenericDash[5][5] << 8) + (GenericDash[5][4] << 0)) * 0.1;
+			return (signed int)raw * 0.1;
 			break;
 		case ECU_CAM_EXHAUST_POSITION_L_DEGREES:
-			return (signed int)((GenericDash[5][7] << 8) + (GenericDash[5][6] << 0)) * -0.1;
+			return (signed int)raw * -0.1;
 			break;
 		case ECU_CAM_EXHAUST_POSITION_R_DEGREES:
-			return (signed int)((GenericDash[6][3] << 8) + (GenericDash[6][2] << 0)) * -0.1;
+			return (signed int)raw * -0.1;
 			break;
 		case ECU_LAMBDA_1_LAMBDA:
-			return (signed int)((GenericDash[6][5] << 8) + (GenericDash[6][4] << 0)) * 0.001;
+			return (signed int)raw * 0.001;
 			break;
 		case ECU_LAMBDA_2_LAMBDA:
-			return (signed int)((GenericDash[6][7] << 8) + (GenericDash[6][6] << 0)) * 0.001;
+			return (signed int)raw * 0.001;
 			break;
 		case ECU_TRIGGER_1_ERROR_COUNT:
-			return (signed int)((GenericDash[7][3] << 8) + (GenericDash[7][2] << 0));
+			return (signed int)raw;
 			break;
 		case ECU_FAULT_CODE:
-			return (signed int)((GenericDash[7][5] << 8) + (GenericDash[7][4] << 0));
+			return (signed int)raw;
 			break;
 		case ECU_FUEL_PRESSURE_KPA:
-			return (signed int)((GenericDash[7][7] << 8) + (GenericDash[7][6] << 0));
+			return (signed int)raw;
 			break;
 		case ECU_OIL_TEMPERATURE_DEGREES_C:
-			return (signed int)((GenericDash[8][3] << 8) + (GenericDash[8][2] << 0)) - 50;
+			return (signed int)raw - 50;
 			break;
 		case ECU_OIL_PRESSURE_KPA:
-			return (signed int)((GenericDash[8][5] << 8) + (GenericDash[8][4] << 0));
+			return (signed int)raw;
 			break;
 		case ECU_LEFT_FRONT_WHEEL_SPEED_KPH:
-			return (signed int)((GenericDash[8][7] << 8) + (GenericDash[8][6] << 0)) * 0.1;
+			return (signed int)raw * 0.1;
 			break;
 		case ECU_LEFT_REAR_WHEEL_SPEED_KPH:
-			return (signed int)((GenericDash[9][3] << 8) + (GenericDash[9][2] << 0)) * 0.1;
+			return (signed int)raw * 0.1;
 			break;
 		case ECU_RIGHT_FRONT_WHEEL_SPEED_KPH:
-			return (signed int)((GenericDash[9][5] << 8) + (GenericDash[9][4] << 0)) * 0.1;
+			return (signed int)raw * 0.1;
 			break;
 		case ECU_RIGHT_REAR_WHEEL_SPEED_KPH:
-			return (signed int)((GenericDash[9][7] << 8) + (GenericDash[9][6] << 0)) * 0.1;
+			return (signed int)raw * 0.1;
 			break;
 		case ECU_KNOCK_LEVEL_1_COUNT:
-			return (signed int)((GenericDash[10][3] << 8) + (GenericDash[10][2] << 0)) * 5;
+			return (signed int)raw * 5;
 			break;
 		case ECU_KNOCK_LEVEL_2_COUNT:
-			return (signed int)((GenericDash[10][5] << 8) + (GenericDash[10][4] << 0)) * 5;
+			return (signed int)raw * 5;
 			break;
 		case ECU_KNOCK_LEVEL_3_COUNT:
-			return (signed int)((GenericDash[10][7] << 8) + (GenericDash[10][6] << 0)) * 5;
+			return (signed int)raw * 5;
 			break;
 		case ECU_KNOCK_LEVEL_4_COUNT:
-			return (signed int)((GenericDash[11][3] << 8) + (GenericDash[11][2] << 0)) * 5;
+			return (signed int)raw * 5;
 			break;
 		case ECU_KNOCK_LEVEL_5_COUNT:
-			return (signed int)((GenericDash[11][5] << 8) + (GenericDash[11][4] << 0)) * 5;
+			return (signed int)raw * 5;
 			break;
 		case ECU_KNOCK_LEVEL_6_COUNT:
-			return (signed int)((GenericDash[11][7] << 8) + (GenericDash[11][6] << 0)) * 5;
+			return (signed int)raw * 5;
 			break;
 		case ECU_KNOCK_LEVEL_7_COUNT:
-			return (signed int)((GenericDash[12][3] << 8) + (GenericDash[12][2] << 0)) * 5;
+			return (signed int)raw * 5;
 			break;
 		case ECU_KNOCK_LEVEL_8_COUNT:
-			return (signed int)((GenericDash[12][5] << 8) + (GenericDash[12][4] << 0)) * 5;
+			return (signed int)raw * 5;
 			break;
 		case ECU_LIMIT_FLAGS_BITFIELD:
-			return (signed int)((GenericDash[12][7] << 8) + (GenericDash[12][6] << 0));
+			return (signed int)raw;
 			break;
 		case ECU_ACCELERATOR_POSITION_PERCENT:
-			return (signed int)((GenericDash[13][3] << 8) + (GenericDash[13][2] << 0)) * 0.1;
+			return (signed int)raw * 0.1;
 			break;
 		case ECU_ETHANOL_CONTENT_PERCENT:
-			return (signed int)((GenericDash[13][5] << 8) + (GenericDash[13][4] << 0)) * 0.1;
+			return (signed int)raw * 0.1;
 			break;
 		case ECU_STATUS_BITFIELD:
-			return (signed int)((GenericDash[13][7] << 8) + (GenericDash[13][6] << 0));
+			return (signed int)raw;
 			break;
 		default:
 			return -1;
@@ -149,25 +190,63 @@ float getGenericDashValue(GenericDashParameters param) {
 	}
 }
 
+float getGenericDashContextValue(const GenericDashContext* context, GenericDashParameters param) {
+	if ((int)param < 0 || (int)param >= Generic_Dash_Parameter_Count) return -1;
+	return decodeGenericDashValue(param, context->words[param]);
+}
+
+float getGenericDashValue(GenericDashParameters param) {
+	return getGenericDashContextValue(&GenericDash, param);
+}
+
+uint16_t getGenericDashContextLimitFlags(const GenericDashContext* context) {
+	return context->words[ECU_LIMIT_FLAGS_BITFIELD];
+}
+
+uint16_t getGenericDashLimitFlags(void) {
+	return getGenericDashContextLimitFlags(&GenericDash);
+}
+
+bool getGenericDashContextLimitFlag(const GenericDashContext* context, GenericDashLimitFlags param) {
+		if ((int)param < 0 || (int)param >= Generic_Dash_Limit_Flag_Count) return false;
+		return (bool)((context->words[ECU_LIMIT_FLAGS_BITFIELD] >> (unsigned int)param) & 0x1);
+}
+
 bool getGenericDashLimitFlag(GenericDashLimitFlags param) {
-		unsigned int flags = (unsigned int)getGenericDashValue(ECU_LIMIT_FLAGS_BITFIELD);
-		return (bool)((flags >> (unsigned int)param) & 0x1);
+	return getGenericDashContextLimitFlag(&GenericDash, param);
 }
 
-unsigned char getGenericDashFeatureStatus(GenericDashFeatureStatuses param) {
-		unsigned int statuses = (unsigned int)getGenericDashValue(ECU_STATUS_BITFIELD);
+GenericDashFeatureStates decodeGenericDashFeatureStates(uint16_t rawValue) {
+	GenericDashFeatureStates states;
+	states.antiLag = (unsigned char)((rawValue >> 0x5) & 0x7);
+	states.launchControl = (unsigned char)((rawValue >> 0x3) & 0x3);
+	states.tractionControl = (unsigned char)((rawValue >> 0x0) & 0x7);
+	states.cruiseControl = (unsigned char)((rawValue >> 0xC) & 0x7);
+	return states;
+}
+
+GenericDashFeatureStates getGenericDashContextFeatureStates(const GenericDashContext* context) {
+	return decodeGenericDashFeatureStates(context->words[ECU_STATUS_BITFIELD]);
+}
+
+GenericDashFeatureStates getGenericDashFeatureStates(void) {
+	return getGenericDashContextFeatureStates(&GenericDash);
+}
+
+unsigned char getGenericDashContextFeatureStatus(const GenericDashContext* context, GenericDashFeatureStatuses param) {
+		GenericDashFeatureStates states = getGenericDashContextFeatureStates(context);
 		switch (param) {
 		case STATUS_ANTI_LAG:
-				return (unsigned char)((statuses >> 0x5) & 0x7);
+				return states.antiLag;
 				break;
 		case STATUS_LAUNCH_CONTROL:
-				return (unsigned char)((statuses >> 0x3) & 0x3);
+				return states.launchControl;
 				break;
 		case STATUS_TRACTION_CONTROL:
-				return (unsigned char)((statuses >> 0x0) & 0x7);
+				return states.tractionControl;
 				break;
 		case STATUS_CRUISE_CONTROL:
-				return (unsigned char)((statuses >> 0xC) & 0x7);
+				return states.cruiseControl;
 				break;
 		default:
 				return -1;
@@ -175,6 +254,10 @@ unsigned char getGenericDashFeatureStatus(GenericDashFeatureStatuses param) {
 		}
 }
 
+unsigned char getGenericDashFeatureStatus(GenericDashFeatureStatuses param) {
+	return getGenericDashContextFeatureStatus(&GenericDash, param);
+}
+
 #ifndef NO_DASH_VALUE_STRINGS
 
 /*
@@ -228,7 +311,7 @@ const char *GenericDashParameterNames[] = {
 
 int linkGenericDashSplitString(const char* inputArray, const char* inputDelimeter, int itemIndex, char* outputArray) {
 	int i = 0;
-	char buffer[strlen(inputArray)];
+	char buffer[strlen(inputArray) + 1];
 	strcpy(buffer, inputArray);
 	char* itemPtr = strtok(buffer, inputDelimeter);
 	while (itemPtr != NULL) {
@@ -305,6 +388,275 @@ int getGenericDashLimitFlagName(GenericDashLimitFlags param, char* dashLimitFlag
 	return sprintf(dashLimitFlagInfo, "%s", GenericDashLimitFlagsNames[param]);
 }
 
+/*
+ Feature statuses
+ */
+const char *GenericDashFeatureStatusNames[] = {
+  "Anti-Lag",
+  "Launch Control",
+  "Traction Control",
+  "Cruise Control",
+};
+
+int getGenericDashFeatureStatusName(GenericDashFeatureStatuses param, char* dashFeatureStatusInfo) {
+	if ((int)param < 0 || (int)param >= Generic_Dash_Feature_Statuses_Count) return 0;
+	return sprintf(dashFeatureStatusInfo, "%s", GenericDashFeatureStatusNames[param]);
+}
+
+/*
+ Feature states
+ */
+const char *GenericDashStatesAntiLagNames[] = {
+  "System Off",
+  "Active",
+  "Off - Low RPM",
+  "Armed Cyclic Off",
+  "Armed Cyclic Active",
+  "Cyclic Cooldown Active",
+  "Disarmed Cyclic Active",
+};
+
+const char *GenericDashStatesLaunchControlNames[] = {
+  "Off",
+  "On - Active",
+  "On - Inactive",
+};
+
+const char *GenericDashStatesTractionControlNames[] = {
+  "Off",
+  "Off - RPM Lockout",
+  "Off - TPS Lockout",
+  "Off - Speed Lockout",
+  "Ready",
+  "Active",
+  "Disabled",
+};
+
+const char *GenericDashStatesCruiseControlNames[] = {
+  "Off",
+  "Enabled",
+  "Active",
+  "Startup Lockout",
+  "Min RPM",
+  "Max RPM",
+  "CAN Error",
+};
+
+int getGenericDashFeatureStateName(GenericDashFeatureStatuses param, unsigned char state, char* dashFeatureStateInfo) {
+	const char **names;
+	unsigned char count;
+	switch (param) {
+		case STATUS_ANTI_LAG:
+			names = GenericDashStatesAntiLagNames;
+			count = Generic_Dash_States_AntiLag_Count;
+			break;
+		case STATUS_LAUNCH_CONTROL:
+			names = GenericDashStatesLaunchControlNames;
+			count = Generic_Dash_States_Launch_Control_Count;
+			break;
+		case STATUS_TRACTION_CONTROL:
+			names = GenericDashStatesTractionControlNames;
+			count = Generic_Dash_States_Traction_Control_Count;
+			break;
+		case STATUS_CRUISE_CONTROL:
+			names = GenericDashStatesCruiseControlNames;
+			count = Generic_Dash_States_Cruise_Control_Count;
+			break;
+		default:
+			return 0;
+	}
+	if (state >= count) return 0;
+	return sprintf(dashFeatureStateInfo, "%s", names[state]);
+}
+
+#ifndef NO_DASH_NAME_LOOKUP
+
+/*
+ Name lookup indexes - every name above plus a short ID, ie. "Engine Speed" and
+ "RPM". These must be kept sorted case-insensitively as they're binary searched
+ */
+typedef struct {
+	const char* name;
+	unsigned char id;
+} GenericDashNameIndex;
+
+static const GenericDashNameIndex GenericDashParameterIndex[] = {
+	{ "Accelerator Position", ECU_ACCELERATOR_POSITION_PERCENT },
+	{ "APS", ECU_ACCELERATOR_POSITION_PERCENT },
+	{ "BAP", ECU_BAROMETRIC_PRESSURE_KPA },
+	{ "Barometric Pressure", ECU_BAROMETRIC_PRESSURE_KPA },
+	{ "BATT", ECU_BATTERY_VOLTAGE },
+	{ "Battery Voltage", ECU_BATTERY_VOLTAGE },
+	{ "Cam Exhaust Position L", ECU_CAM_EXHAUST_POSITION_L_DEGREES },
+	{ "Cam Exhaust Position R", ECU_CAM_EXHAUST_POSITION_R_DEGREES },
+	{ "Cam Inlet Position L", ECU_CAM_INLET_POSITION_L_DEGREES },
+	{ "Cam Inlet Position R", ECU_CAM_INLET_POSITION_R_DEGREES },
+	{ "CAMEL", ECU_CAM_EXHAUST_POSITION_L_DEGREES },
+	{ "CAMER", ECU_CAM_EXHAUST_POSITION_R_DEGREES },
+	{ "CAMIL", ECU_CAM_INLET_POSITION_L_DEGREES },
+	{ "CAMIR", ECU_CAM_INLET_POSITION_R_DEGREES },
+	{ "ECT", ECU_ENGINE_COOLANT_TEMPERATURE_DEGREES_C },
+	{ "Engine Coolant Temp", ECU_ENGINE_COOLANT_TEMPERATURE_DEGREES_C },
+	{ "Engine Speed", ECU_ENGINE_SPEED_RPM },
+	{ "ETH", ECU_ETHANOL_CONTENT_PERCENT },
+	{ "Ethanol Content", ECU_ETHANOL_CONTENT_PERCENT },
+	{ "FAULT", ECU_FAULT_CODE },
+	{ "Fault Codes", ECU_FAULT_CODE },
+	{ "FP", ECU_FUEL_PRESSURE_KPA },
+	{ "Fuel Pressure", ECU_FUEL_PRESSURE_KPA },
+	{ "GEAR", ECU_GEAR_POSITION },
+	{ "Gear Position", ECU_GEAR_POSITION },
+	{ "IAT", ECU_INTAKE_AIR_TEMPERATURE_DEGRESS_C },
+	{ "IDC", ECU_INJECTOR_DUTY_CYCLE_PERCENT },
+	{ "IDC2", ECU_SECOND_STAGE_INJECTOR_DUTY_CYCLE_PERCENT },
+	{ "IGN", ECU_IGNITION_TIMING_DEGREES },
+	{ "Ignition Timing", ECU_IGNITION_TIMING_DEGREES },
+	{ "Injector Duty Cycle", ECU_INJECTOR_DUTY_CYCLE_PERCENT },
+	{ "Injector Pulse Width", ECU_INJECTOR_PULSE_WIDTH_MS },
+	{ "Injector Timing", ECU_INJECTOR_TIMING_DEGREES },
+	{ "INJT", ECU_INJECTOR_TIMING_DEGREES },
+	{ "Intake Air Temp", ECU_INTAKE_AIR_TEMPERATURE_DEGRESS_C },
+	{ "IPW", ECU_INJECTOR_PULSE_WIDTH_MS },
+	{ "Knock Level Cyl 1", ECU_KNOCK_LEVEL_1_COUNT },
+	{ "Knock Level Cyl 2", ECU_KNOCK_LEVEL_2_COUNT },
+	{ "Knock Level Cyl 3", ECU_KNOCK_LEVEL_3_COUNT },
+	{ "Knock Level Cyl 4", ECU_KNOCK_LEVEL_4_COUNT },
+	{ "Knock Level Cyl 5", ECU_KNOCK_LEVEL_5_COUNT },
+	{ "Knock Level Cyl 6", ECU_KNOCK_LEVEL_6_COUNT },
+	{ "Knock Level Cyl 7", ECU_KNOCK_LEVEL_7_COUNT },
+	{ "Knock Level Cyl 8", ECU_KNOCK_LEVEL_8_COUNT },
+	{ "KNOCK1", ECU_KNOCK_LEVEL_1_COUNT },
+	{ "KNOCK2", ECU_KNOCK_LEVEL_2_COUNT },
+	{ "KNOCK3", ECU_KNOCK_LEVEL_3_COUNT },
+	{ "KNOCK4", ECU_KNOCK_LEVEL_4_COUNT },
+	{ "KNOCK5", ECU_KNOCK_LEVEL_5_COUNT },
+	{ "KNOCK6", ECU_KNOCK_LEVEL_6_COUNT },
+	{ "KNOCK7", ECU_KNOCK_LEVEL_7_COUNT },
+	{ "KNOCK8", ECU_KNOCK_LEVEL_8_COUNT },
+	{ "LAM1", ECU_LAMBDA_1_LAMBDA },
+	{ "LAM2", ECU_LAMBDA_2_LAMBDA },
+	{ "Lambda Sensor 1", ECU_LAMBDA_1_LAMBDA },
+	{ "Lambda Sensor 2", ECU_LAMBDA_2_LAMBDA },
+	{ "LF Wheel Speed", ECU_LEFT_FRONT_WHEEL_SPEED_KPH },
+	{ "LFWS", ECU_LEFT_FRONT_WHEEL_SPEED_KPH },
+	{ "Limit Flags", ECU_LIMIT_FLAGS_BITFIELD },
+	{ "LIMITS", ECU_LIMIT_FLAGS_BITFIELD },
+	{ "LR Wheel Speed", ECU_LEFT_REAR_WHEEL_SPEED_KPH },
+	{ "LRWS", ECU_LEFT_REAR_WHEEL_SPEED_KPH },
+	{ "MAF", ECU_MASS_AIR_FLOW_GRAMS_PER_SECOND },
+	{ "Manifold Abs. Pres.", ECU_MAP_KPA },
+	{ "Manifold Gauge Pres.", ECU_MGP_KPA },
+	{ "MAP", ECU_MAP_KPA },
+	{ "Mass Air Flow", ECU_MASS_AIR_FLOW_GRAMS_PER_SECOND },
+	{ "MGP", ECU_MGP_KPA },
+	{ "Oil Pressure", ECU_OIL_PRESSURE_KPA },
+	{ "Oil Temp", ECU_OIL_TEMPERATURE_DEGREES_C },
+	{ "OILP", ECU_OIL_PRESSURE_KPA },
+	{ "OILT", ECU_OIL_TEMPERATURE_DEGREES_C },
+	{ "RF Wheel Speed", ECU_RIGHT_FRONT_WHEEL_SPEED_KPH },
+	{ "RFWS", ECU_RIGHT_FRONT_WHEEL_SPEED_KPH },
+	{ "RPM", ECU_ENGINE_SPEED_RPM },
+	{ "RR Wheel Speed", ECU_RIGHT_REAR_WHEEL_SPEED_KPH },
+	{ "RRWS", ECU_RIGHT_REAR_WHEEL_SPEED_KPH },
+	{ "Secondary Injector DC", ECU_SECOND_STAGE_INJECTOR_DUTY_CYCLE_PERCENT },
+	{ "STATUS", ECU_STATUS_BITFIELD },
+	{ "Statuses", ECU_STATUS_BITFIELD },
+	{ "Throttle Position", ECU_THROTTLE_POSITION_PERCENT },
+	{ "TPS", ECU_THROTTLE_POSITION_PERCENT },
+	{ "TRIG1ERR", ECU_TRIGGER_1_ERROR_COUNT },
+	{ "Trigger 1 Errors", ECU_TRIGGER_1_ERROR_COUNT },
+};
+
+static const GenericDashNameIndex GenericDashLimitFlagIndex[] = {
+	{ "ALIGNCUT", LIMITS_FLAG_ANTI_LAG_IGNITION_CUT },
+	{ "Anti-Lag Ign Cut", LIMITS_FLAG_ANTI_LAG_IGNITION_CUT },
+	{ "CYCIDLE", LIMITS_FLAG_CYCLIC_IDLE_ACTIVE },
+	{ "Cyclic Idle", LIMITS_FLAG_CYCLIC_IDLE_ACTIVE },
+	{ "E-Throttle Limit", LIMITS_FLAG_ETHROTTLE_LIMIT },
+	{ "ECU High Voltage", LIMITS_FLAG_HIGH_VOLTAGE_SUPPLY_LIMIT },
+	{ "ECU Low Voltage", LIMITS_FLAG_LOW_VOLTAGE_SUPPLY_LIMIT },
+	{ "ETLIM", LIMITS_FLAG_ETHROTTLE_LIMIT },
+	{ "GP RPM Limit 1", LIMITS_FLAG_GP_RPM_LIMIT_1 },
+	{ "GP RPM Limit 2", LIMITS_FLAG_GP_RPM_LIMIT_2 },
+	{ "GPLIM1", LIMITS_FLAG_GP_RPM_LIMIT_1 },
+	{ "GPLIM2", LIMITS_FLAG_GP_RPM_LIMIT_2 },
+	{ "HIVOLT", LIMITS_FLAG_HIGH_VOLTAGE_SUPPLY_LIMIT },
+	{ "ISCLIM", LIMITS_FLAG_CL_STEPPER_LIMIT },
+	{ "Launch RPM Limit", LIMITS_FLAG_LAUNCH_RPM_LIMIT },
+	{ "LAUNCHLIM", LIMITS_FLAG_LAUNCH_RPM_LIMIT },
+	{ "LOVOLT", LIMITS_FLAG_LOW_VOLTAGE_SUPPLY_LIMIT },
+	{ "MAP Limit", LIMITS_FLAG_MAP_LIMIT },
+	{ "MAPLIM", LIMITS_FLAG_MAP_LIMIT },
+	{ "Max Ign Timing", LIMITS_FLAG_MAXIMUM_IGNITION_FLAG },
+	{ "Max ISC Steps", LIMITS_FLAG_CL_STEPPER_LIMIT },
+	{ "MAXIGN", LIMITS_FLAG_MAXIMUM_IGNITION_FLAG },
+	{ "Overrun", LIMITS_FLAG_OVERRUN_FLAG },
+	{ "RPM Limit", LIMITS_FLAG_RPM_LIMIT },
+	{ "RPMLIM", LIMITS_FLAG_RPM_LIMIT },
+	{ "SPDLIM", LIMITS_FLAG_SPEED_LIMIT },
+	{ "Speed Limit", LIMITS_FLAG_SPEED_LIMIT },
+	{ "TCLIM", LIMITS_FLAG_TRACTION_LIMIT },
+	{ "Traction Limit", LIMITS_FLAG_TRACTION_LIMIT },
+	{ "Wakeup", LIMITS_FLAG_WAKEUP_FLAG },
+};
+
+static const GenericDashNameIndex GenericDashFeatureStatusIndex[] = {
+	{ "AL", STATUS_ANTI_LAG },
+	{ "Anti-Lag", STATUS_ANTI_LAG },
+	{ "CC", STATUS_CRUISE_CONTROL },
+	{ "Cruise Control", STATUS_CRUISE_CONTROL },
+	{ "Launch Control", STATUS_LAUNCH_CONTROL },
+	{ "LC", STATUS_LAUNCH_CONTROL },
+	{ "TC", STATUS_TRACTION_CONTROL },
+	{ "Traction Control", STATUS_TRACTION_CONTROL },
+};
+
+static int linkGenericDashCompareNames(const char* a, const char* b) {
+	for (;; a++, b++) {
+		unsigned char lowerA = (unsigned char)*a;
+		unsigned char lowerB = (unsigned char)*b;
+		if (lowerA >= 'A' && lowerA <= 'Z') lowerA += 'a' - 'A';
+		if (lowerB >= 'A' && lowerB <= 'Z') lowerB += 'a' - 'A';
+		if (lowerA != lowerB || lowerA == 0) return (int)lowerA - (int)lowerB;
+	}
+}
+
+static int linkGenericDashFindName(const GenericDashNameIndex* index, int indexLength, const char* name) {
+	if (name == NULL) return -1;
+	int lowest = 0, highest = indexLength - 1;
+	while (lowest <= highest) {
+		int middle = (lowest + highest) / 2;
+		int comparison = linkGenericDashCompareNames(name, index[middle].name);
+		if (comparison == 0) return index[middle].id;
+		if (comparison < 0) highest = middle - 1;
+		else lowest = middle + 1;
+	}
+	return -1;
+}
+
+bool findGenericDashParameter(const char* name, GenericDashParameters* param) {
+	int id = linkGenericDashFindName(GenericDashParameterIndex, sizeof(GenericDashParameterIndex) / sizeof(GenericDashParameterIndex[0]), name);
+	if (id < 0) return false;
+	*param = (GenericDashParameters)id;
+	return true;
+}
+
+bool findGenericDashLimitFlag(const char* name, GenericDashLimitFlags* param) {
+	int id = linkGenericDashFindName(GenericDashLimitFlagIndex, sizeof(GenericDashLimitFlagIndex) / sizeof(GenericDashLimitFlagIndex[0]), name);
+	if (id < 0) return false;
+	*param = (GenericDashLimitFlags)id;
+	return true;
+}
+
+bool findGenericDashFeatureStatus(const char* name, GenericDashFeatureStatuses* param) {
+	int id = linkGenericDashFindName(GenericDashFeatureStatusIndex, sizeof(GenericDashFeatureStatusIndex) / sizeof(GenericDashFeatureStatusIndex[0]), name);
+	if (id < 0) return false;
+	*param = (GenericDashFeatureStatuses)id;
+	return true;
+}
+
+#endif // NO_DASH_NAME_LOOKUP
+
 #endif // NO_DASH_VALUE_STRINGS
 
 
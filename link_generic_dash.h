@@ -11,6 +11,10 @@
  note the default units of measurement ie. all pressure values are kPa,
  all temperature values are °C and all time-based values are milliseconds..
 
+ #define NO_DASH_NAME_LOOKUP
+ Will not include the indexes used to look up parameters, limit flags and
+ feature statuses by name - implied by NO_DASH_VALUE_STRINGS.
+
  #define NO_FAULT_CODE_STRINGS
  Same as above, will not include fault code strings, meaning you won't be
  able to decode what a fault code number means.
@@ -29,8 +33,19 @@ extern "C" {
 #include <string.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <limits.h>
 
+/**
+ * @brief Default CAN ID Generic Dash is sent on, configurable in PCLink
+ */
+#define defaultGenericDashCanId 1000
+
+/**
+ * @brief Total number of CAN frames making up a Generic Dash cycle
+ */
+#define Generic_Dash_Frame_Count 14
+
 /**
  * @brief Maximum string length of any dash parameter name
  */
@@ -202,6 +217,16 @@ typedef enum {
  */
 #define Generic_Dash_States_Cruise_Control_Count STATE_CRUISE_CONTROL_CAN_ERROR + 1
 
+/**
+ * @brief All four feature states at once, each one of the matching GenericDashStates enum
+ */
+typedef struct {
+	unsigned char antiLag;         // GenericDashStatesAntiLag
+	unsigned char launchControl;   // GenericDashStatesLaunchControl
+	unsigned char tractionControl; // GenericDashStatesTractionControl
+	unsigned char cruiseControl;   // GenericDashStatesCruiseControl
+} GenericDashFeatureStates;
+
 /**
  * @brief Amalgamated list of known fault codes between G4+, G4X and G5 boards
  */
@@ -336,12 +361,51 @@ typedef enum {
  */
 #define Link_ECU_Fault_Code_Count ECU_FAULT_DI_DRIVER + 1
 
+/**
+ * @brief A Generic Dash CAN frame along with the time it was received
+ */
+typedef struct {
+	uint64_t timestamp; // Microseconds
+	unsigned char frame[8];
+} GenericDashRecord;
+
+/**
+ * @brief Decoder state for a single Generic Dash stream
+ *
+ * The functions without a context use one built into this library, which is
+ * all you need with a single ECU. Use your own contexts to decode several
+ * streams at once, ie. more than one ECU or one per thread.
+ *
+ * Only the six payload bytes of each frame are kept, as three little-endian
+ * words, so words[param] is the raw value of that parameter. Frame 0 holds
+ * parameters 0 to 2, frame 1 holds 3 to 5 and so on.
+ */
+typedef struct {
+	uint16_t words[Generic_Dash_Parameter_Count];
+} GenericDashContext;
+
+/**
+ * @brief Clear a decoder context ready for use
+ * @param context is the decoder context to clear
+ */
+void initGenericDashContext(GenericDashContext* context);
+
 /**
  * @brief Parse the Link Generic Dash CAN frames ready for later use
  * @param frame is an 8 unsigned char bytes CAN frame to decode
  * @return true if successfully decoded, false otherwise
  */
 bool parseGenericDashCanFrame(unsigned char frame[8]);
+bool parseGenericDashContextCanFrame(GenericDashContext* context, const unsigned char frame[8]);
+
+/**
+ * @brief Build a Generic Dash CAN frame from a decoder context, the reverse of parseGenericDashContextCanFrame
+ * @param context is the decoder context to take the frame's values from
+ * @param index is the frame to build, 0 to Generic_Dash_Frame_Count - 1
+ * @param frame is an 8 unsigned char bytes CAN frame to fill
+ * @return true if successfully encoded, false otherwise
+ */
+bool encodeGenericDashContextCanFrame(const GenericDashContext* context, unsigned char index, unsigned char frame[8]);
 
 /**
  * @brief Get a specific value from the Generic Dash buffer
@@ -349,6 +413,23 @@ bool parseGenericDashCanFrame(unsigned char frame[8]);
  * @return float value of the requested parameter
  */
 float getGenericDashValue(GenericDashParameters param);
+float getGenericDashContextValue(const GenericDashContext* context, GenericDashParameters param);
+
+/**
+ * @brief Get the raw value of a specific parameter as sent by the ECU, before any scaling
+ * @param param is one of enum GenericDashParameters to return
+ * @return uint16_t raw value of the requested parameter or 0 on failure
+ */
+uint16_t getGenericDashRawValue(GenericDashParameters param);
+uint16_t getGenericDashContextRawValue(const GenericDashContext* context, GenericDashParameters param);
+
+/**
+ * @brief Scale a raw value the same way getGenericDashValue does
+ * @param param is one of enum GenericDashParameters the raw value belongs to
+ * @param rawValue is the raw value as sent by the ECU
+ * @return float value of the requested parameter
+ */
+float decodeGenericDashValue(GenericDashParameters param, uint16_t rawValue);
 
 /**
  * @brief Get a specific limit flag from the Generic Dash Buffer
@@ -356,6 +437,7 @@ float getGenericDashValue(GenericDashParameters param);
  * @return bool value of the requested limit flag
  */
 bool getGenericDashLimitFlag(GenericDashLimitFlags param);
+bool getGenericDashContextLimitFlag(const GenericDashContext* context, GenericDashLimitFlags param);
 
 /**
  * @brief Get a specific feature status from the Generic Dash Buffer
@@ -363,6 +445,28 @@ bool getGenericDashLimitFlag(GenericDashLimitFlags param);
  * @return unsigned char value of the requested feature status
  */
 unsigned char getGenericDashFeatureStatus(GenericDashFeatureStatuses param);
+unsigned char getGenericDashContextFeatureStatus(const GenericDashContext* context, GenericDashFeatureStatuses param);
+
+/**
+ * @brief Get every limit flag at once, bit n is GenericDashLimitFlags n
+ * @return uint16_t mask of all limit flags
+ */
+uint16_t getGenericDashLimitFlags(void);
+uint16_t getGenericDashContextLimitFlags(const GenericDashContext* context);
+
+/**
+ * @brief Get every feature status at once
+ * @return GenericDashFeatureStates the state of each feature
+ */
+GenericDashFeatureStates getGenericDashFeatureStates(void);
+GenericDashFeatureStates getGenericDashContextFeatureStates(const GenericDashContext* context);
+
+/**
+ * @brief Split a raw ECU_STATUS_BITFIELD value into feature states, ie. from a log
+ * @param rawValue is the raw ECU_STATUS_BITFIELD value as sent by the ECU
+ * @return GenericDashFeatureStates the state of each feature
+ */
+GenericDashFeatureStates decodeGenericDashFeatureStates(uint16_t rawValue);
 
 #ifndef NO_DASH_VALUE_STRINGS
 
@@ -399,6 +503,41 @@ signed int getGenericDashParameterMaximumValue(GenericDashParameters param);
  */
 int getGenericDashLimitFlagName(GenericDashLimitFlags param, char* dashLimitFlagInfo);
 
+/**
+ * @brief Gets a human-readable name for a given GenericDashFeatureStatuses
+ * @param param is one of enum GenericDashFeatureStatuses to return
+ * @param dashFeatureStatusInfo is a char array pointer that will get filled with the requested data
+ * @return int value of the number of bytes written to dashFeatureStatusInfo (0 on failure)
+ */
+int getGenericDashFeatureStatusName(GenericDashFeatureStatuses param, char* dashFeatureStatusInfo);
+
+/**
+ * @brief Gets a human-readable name for a state of a given GenericDashFeatureStatuses
+ * @param param is one of enum GenericDashFeatureStatuses the state belongs to
+ * @param state is one of the matching GenericDashStates enum, ie. from getGenericDashFeatureStatus
+ * @param dashFeatureStateInfo is a char array pointer that will get filled with the requested data
+ * @return int value of the number of bytes written to dashFeatureStateInfo (0 on failure)
+ */
+int getGenericDashFeatureStateName(GenericDashFeatureStatuses param, unsigned char state, char* dashFeatureStateInfo);
+
+#ifndef NO_DASH_NAME_LOOKUP
+
+/**
+ * @brief Finds a parameter, limit flag or feature status by name, ie. from a config file
+ *
+ * Accepts the names above or a short ID (ie. "Engine Speed" or "RPM", "RPM Limit"
+ * or "RPMLIM", "Launch Control" or "LC") in any case.
+ *
+ * @param name is the name to look up
+ * @param param is set to the matching enum value if found
+ * @return true if the name was found, false otherwise
+ */
+bool findGenericDashParameter(const char* name, GenericDashParameters* param);
+bool findGenericDashLimitFlag(const char* name, GenericDashLimitFlags* param);
+bool findGenericDashFeatureStatus(const char* name, GenericDashFeatureStatuses* param);
+
+#endif // NO_DASH_NAME_LOOKUP
+
 #endif // NO_DASH_VALUE_STRINGS
 
 #ifndef NO_FAULT_CODE_STRINGS
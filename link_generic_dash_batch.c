@@ -0,0 +1,71 @@
+/*
+ Any additions to this file will need suitable additions to link_generic_dash_batch.h
+ For documentation please the above file.
+ */
+
+#include "link_generic_dash_batch.h"
+
+/*
+ Writing a row at a time touches every column for every record, which is far
+ slower than writing each column in a run. Records are decoded in blocks
+ small enough to stay in cache, once to move the context along and then once
+ per frame to fill in that frame's three columns for the whole block.
+ */
+#define GenericDashBatchBlockRows 512
+
+size_t decodeGenericDashBatch(GenericDashContext* context, const GenericDashRecord* records, size_t recordCount, uint16_t* const rawColumns[Generic_Dash_Parameter_Count], float* const scaledColumns[Generic_Dash_Parameter_Count]) {
+	float values[Generic_Dash_Parameter_Count];
+	uint16_t rawScratch[GenericDashBatchBlockRows];
+	float scaledScratch[GenericDashBatchBlockRows];
+	uint16_t wantsRaw = 0;
+	uint16_t wantsScaled = 0;
+	size_t accepted = 0;
+
+	for (int i = 0; i < Generic_Dash_Parameter_Count; i++) {
+		if (rawColumns != NULL && rawColumns[i] != NULL) wantsRaw |= 1 << (i / 3);
+		if (scaledColumns != NULL && scaledColumns[i] != NULL) wantsScaled |= 1 << (i / 3);
+		values[i] = decodeGenericDashValue((GenericDashParameters)i, context->words[i]);
+	}
+
+	for (size_t first = 0; first < recordCount; first += GenericDashBatchBlockRows) {
+		const GenericDashRecord* block = &records[first];
+		size_t rows = recordCount - first < GenericDashBatchBlockRows ? recordCount - first : GenericDashBatchBlockRows;
+		uint16_t words[Generic_Dash_Parameter_Count];
+
+		memcpy(words, context->words, sizeof(words));
+		for (size_t row = 0; row < rows; row++)
+			if (parseGenericDashContextCanFrame(context, block[row].frame)) accepted++;
+
+		for (int frame = 0; frame < Generic_Dash_Frame_Count; frame++) {
+			bool raw = wantsRaw & (1 << frame);
+			bool scaled = wantsScaled & (1 << frame);
+			if (!raw && !scaled) continue;
+
+			// Skipped columns in a wanted frame are written to scratch so the loop doesn't need to check
+			uint16_t* rawOut[3];
+			float* scaledOut[3];
+			uint16_t* current = &words[frame * 3];
+			float* value = &values[frame * 3];
+			for (int i = 0; i < 3; i++) {
+				int param = frame * 3 + i;
+				rawOut[i] = raw && rawColumns[param] != NULL ? &rawColumns[param][first] : rawScratch;
+				scaledOut[i] = scaled && scaledColumns[param] != NULL ? &scaledColumns[param][first] : scaledScratch;
+			}
+
+			for (size_t row = 0; row < rows; row++) {
+				const unsigned char* data = block[row].frame;
+				if (data[0] == frame && data[1] == 0) {
+					for (int i = 0; i < 3; i++) {
+						current[i] = (uint16_t)((data[3 + i * 2] << 8) | data[2 + i * 2]);
+						if (scaled) value[i] = decodeGenericDashValue((GenericDashParameters)(frame * 3 + i), current[i]);
+					}
+				}
+				if (raw)
+					for (int i = 0; i < 3; i++) rawOut[i][row] = current[i];
+				if (scaled)
+					for (int i = 0; i < 3; i++) scaledOut[i][row] = value[i];
+			}
+		}
+	}
+	return accepted;
+}
@@ -0,0 +1,40 @@
+/*
+ link_generic_dash_batch.h - Columnar batch decoder for recorded Generic Dash frames
+ For copyright and license information see LICENSE
+
+ Decodes an array of recorded frames into one column per parameter with a row
+ for every record, ie. for handing a log to an analysis tool. Each parameter
+ holds its value from one update to the next, so every row is the full state
+ a decoder would have had after that record. Columns can be raw values as
+ sent by the ECU, values scaled the same way getGenericDashValue does, or both.
+
+ Decoding picks up from the state of the context passed in and leaves it at
+ the state after the last record, so a long log can be decoded one batch at a
+ time. For the Python / NumPy bindings see extras/python.
+ */
+
+#ifndef link_generic_dash_batch_h
+#define link_generic_dash_batch_h
+
+#include "link_generic_dash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Decodes a batch of records into columns
+ * @param context is the decoder context to start from, left at the state after the last record
+ * @param records is an array of records to decode
+ * @param recordCount is the number of records, and the length of every column
+ * @param rawColumns is an array of Generic_Dash_Parameter_Count raw value columns, NULL entries are skipped, or NULL for none
+ * @param scaledColumns is an array of Generic_Dash_Parameter_Count scaled value columns, NULL entries are skipped, or NULL for none
+ * @return size_t number of records that were valid frames
+ */
+size_t decodeGenericDashBatch(GenericDashContext* context, const GenericDashRecord* records, size_t recordCount, uint16_t* const rawColumns[Generic_Dash_Parameter_Count], float* const scaledColumns[Generic_Dash_Parameter_Count]);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // link_generic_dash_batch_h
@@ -0,0 +1,296 @@
+/*
+ Any additions to this file will need suitable additions to link_generic_dash_checkpoint.h
+ For documentation please the above file.
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#include "link_generic_dash_checkpoint.h"
+
+#include <math.h>
+#include <stddef.h>
+
+#ifdef GENERIC_DASH_CHECKPOINT_FILES
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/*
+ CRC-32 a nibble at a time, small enough for the smallest microcontrollers
+ */
+static const uint32_t GenericDashCheckpointCrcTable[16] = {
+	0x00000000, 0x1DB71064, 0x3B6E20C8, 0x26D930AC, 0x76DC4190, 0x6B6B51F4, 0x4DB26158, 0x5005713C,
+	0xEDB88320, 0xF00F9344, 0xD6D6A3E8, 0xCB61B38C, 0x9B64C2B0, 0x86D3D2D4, 0xA00AE278, 0xBDBDF21C,
+};
+
+uint32_t crcGenericDashCheckpoint(uint32_t crc, const void* data, size_t length) {
+	const unsigned char* bytes = (const unsigned char*)data;
+	crc = ~crc;
+	for (size_t i = 0; i < length; i++) {
+		crc ^= bytes[i];
+		crc = (crc >> 4) ^ GenericDashCheckpointCrcTable[crc & 0xF];
+		crc = (crc >> 4) ^ GenericDashCheckpointCrcTable[crc & 0xF];
+	}
+	return ~crc;
+}
+
+static uint32_t getGenericDashCheckpointRecordCrc(const GenericDashCheckpointRecord* record) {
+	return crcGenericDashCheckpoint(0, record, offsetof(GenericDashCheckpointRecord, crc));
+}
+
+static bool isGenericDashCheckpointRecordValid(const GenericDashCheckpointRecord* record) {
+	return record->magic == GenericDashCheckpointMagic && record->version == GenericDashCheckpointVersion &&
+		record->length == sizeof(GenericDashCheckpointRecord) && record->faultCount <= maxGenericDashCheckpointFaults &&
+		record->newestFault < maxGenericDashCheckpointFaults && record->limitEventCount <= maxGenericDashCheckpointLimitEvents &&
+		record->newestLimitEvent < maxGenericDashCheckpointLimitEvents && record->crc == getGenericDashCheckpointRecordCrc(record);
+}
+
+static void pushGenericDashCheckpointEvent(GenericDashCheckpointEvent* events, unsigned char* count, unsigned char* newest, unsigned char maxEvents, uint64_t timestamp, uint16_t value) {
+	/*
+	 Codes cycle, ie. two active faults alternate and limit flags toggle, so one
+	 already in the history is counted and moved to the front rather than
+	 pushing older, different ones out
+	 */
+	for (unsigned char i = 0; i < *count; i++) {
+		unsigned char index = (unsigned char)((*newest + maxEvents - i) % maxEvents);
+		if (events[index].value != value) continue;
+
+		GenericDashCheckpointEvent event = events[index];
+		for (; index != *newest; index = (unsigned char)((index + 1) % maxEvents)) events[index] = events[(index + 1) % maxEvents];
+		event.timestamp = timestamp;
+		if (event.count < UINT16_MAX) event.count++;
+		events[*newest] = event;
+		return;
+	}
+
+	*newest = (unsigned char)((*newest + 1) % maxEvents);
+	events[*newest].timestamp = timestamp;
+	events[*newest].value = value;
+	events[*newest].count = 1;
+	if (*count < maxEvents) (*count)++;
+}
+
+static size_t copyGenericDashCheckpointEvents(const GenericDashCheckpointEvent* ring, unsigned char count, unsigned char newest, unsigned char maxRing, GenericDashCheckpointEvent* events, size_t maxEvents) {
+	size_t copied = 0;
+	for (; copied < count && copied < maxEvents; copied++) events[copied] = ring[(newest + maxRing - copied) % maxRing];
+	return copied;
+}
+
+static void startGenericDashCheckpointSave(GenericDashCheckpoint* checkpoint, uint64_t now) {
+	GenericDashCheckpointRecord* saving = &checkpoint->saving;
+	*saving = checkpoint->state;
+	saving->magic = GenericDashCheckpointMagic;
+	saving->version = GenericDashCheckpointVersion;
+	saving->length = sizeof(GenericDashCheckpointRecord);
+	saving->sequence = checkpoint->state.sequence + 1;
+	saving->timestamp = now;
+	saving->crc = getGenericDashCheckpointRecordCrc(saving);
+
+	// Never the slot holding the newest checkpoint, so there's always one to fall back on
+	checkpoint->nextSlot = (unsigned char)((checkpoint->slot + 1) % checkpoint->device->slotCount);
+	checkpoint->stage = checkpoint->device->erase != NULL ? CHECKPOINT_ERASING : CHECKPOINT_WRITING;
+	checkpoint->erased = 0;
+	checkpoint->written = 0;
+	checkpoint->lastSave = now;
+	checkpoint->changed = false;
+}
+
+static void failGenericDashCheckpointSave(GenericDashCheckpoint* checkpoint) {
+	checkpoint->failures++;
+	checkpoint->stage = CHECKPOINT_IDLE;
+	checkpoint->changed = true;
+}
+
+bool initGenericDashCheckpoint(GenericDashCheckpoint* checkpoint, GenericDashCheckpointDevice* device, uint64_t interval) {
+	if (device->slotSize < sizeof(GenericDashCheckpointRecord) || device->slotCount < 2) return false;
+	if (device->slotSize > UINT32_MAX / device->slotCount) return false;
+	if (device->eraseSize != 0 && device->slotSize % device->eraseSize != 0) return false;
+	memset(checkpoint, 0, sizeof(*checkpoint));
+	checkpoint->device = device;
+	checkpoint->interval = interval;
+	checkpoint->slot = (unsigned char)(device->slotCount - 1);
+	initGenericDashContext(&checkpoint->state.context);
+	resetGenericDashCheckpointSession(checkpoint);
+	return true;
+}
+
+bool loadGenericDashCheckpoint(GenericDashCheckpoint* checkpoint) {
+	GenericDashCheckpointDevice* device = checkpoint->device;
+	bool found = false;
+	for (unsigned char slot = 0; slot < device->slotCount; slot++) {
+		if (!device->read(device, (uint32_t)slot * device->slotSize, &checkpoint->saving, sizeof(GenericDashCheckpointRecord))) continue;
+		if (!isGenericDashCheckpointRecordValid(&checkpoint->saving)) continue;
+		// Newest by sequence number, allowing for it wrapping around
+		if (found && (int32_t)(checkpoint->saving.sequence - checkpoint->state.sequence) <= 0) continue;
+		checkpoint->state = checkpoint->saving;
+		checkpoint->slot = slot;
+		found = true;
+	}
+	checkpoint->changed = false;
+	return found;
+}
+
+bool parseGenericDashCheckpointCanFrame(GenericDashCheckpoint* checkpoint, uint64_t timestamp, const unsigned char frame[8]) {
+	GenericDashCheckpointRecord* state = &checkpoint->state;
+	if (frame[0] >= Generic_Dash_Frame_Count || frame[1] != 0) return false;
+
+	int first = frame[0] * 3;
+	uint16_t previous[3];
+	memcpy(previous, &state->context.words[first], sizeof(previous));
+	parseGenericDashContextCanFrame(&state->context, frame);
+
+	uint16_t bit = (uint16_t)(1 << frame[0]);
+	if (!(state->receivedFrames & bit) || memcmp(previous, &state->context.words[first], sizeof(previous)) != 0) checkpoint->changed = true;
+	state->receivedFrames |= bit;
+	bool firstThisSession = !(state->sessionFrames & bit);
+	state->sessionFrames |= bit;
+
+	for (int param = first; param < first + 3; param++) {
+		uint16_t rawValue = state->context.words[param];
+		if (firstThisSession) {
+			state->minimum[param] = state->maximum[param] = rawValue;
+		} else if (rawValue != state->minimum[param] || rawValue != state->maximum[param]) {
+			// Compared scaled as some parameters are signed, but kept raw to halve the record
+			float value = decodeGenericDashValue((GenericDashParameters)param, rawValue);
+			if (value < decodeGenericDashValue((GenericDashParameters)param, state->minimum[param])) state->minimum[param] = rawValue;
+			if (value > decodeGenericDashValue((GenericDashParameters)param, state->maximum[param])) state->maximum[param] = rawValue;
+		}
+		if (rawValue == previous[param - first]) continue;
+
+		if (param == ECU_FAULT_CODE && rawValue != ECU_FAULT_NONE)
+			pushGenericDashCheckpointEvent(state->faults, &state->faultCount, &state->newestFault, maxGenericDashCheckpointFaults, timestamp, rawValue);
+		else if (param == ECU_LIMIT_FLAGS_BITFIELD)
+			pushGenericDashCheckpointEvent(state->limitEvents, &state->limitEventCount, &state->newestLimitEvent, maxGenericDashCheckpointLimitEvents, timestamp, rawValue);
+	}
+	return true;
+}
+
+GenericDashCheckpointStages serviceGenericDashCheckpoint(GenericDashCheckpoint* checkpoint, uint64_t now) {
+	GenericDashCheckpointDevice* device = checkpoint->device;
+	uint32_t address = (uint32_t)checkpoint->nextSlot * device->slotSize;
+
+	switch (checkpoint->stage) {
+		case CHECKPOINT_IDLE:
+			if (checkpoint->changed && now - checkpoint->lastSave >= checkpoint->interval) startGenericDashCheckpointSave(checkpoint, now);
+			break;
+		case CHECKPOINT_ERASING: {
+			// A sector erase can take tens of milliseconds, so one per call, and only as many as the record covers
+			uint32_t length = device->eraseSize != 0 ? device->eraseSize : device->slotSize;
+			if (!device->erase(device, address + checkpoint->erased, length)) {
+				failGenericDashCheckpointSave(checkpoint);
+				break;
+			}
+			checkpoint->erased += length;
+			if (checkpoint->erased >= sizeof(GenericDashCheckpointRecord)) checkpoint->stage = CHECKPOINT_WRITING;
+			break;
+		}
+		case CHECKPOINT_WRITING: {
+			uint32_t length = sizeof(GenericDashCheckpointRecord) - checkpoint->written;
+			if (device->pageSize != 0 && length > device->pageSize) length = device->pageSize;
+			if (!device->write(device, address + checkpoint->written, (const unsigned char*)&checkpoint->saving + checkpoint->written, length)) {
+				failGenericDashCheckpointSave(checkpoint);
+				break;
+			}
+			checkpoint->written += length;
+			if (checkpoint->written < sizeof(GenericDashCheckpointRecord)) break;
+
+			if (device->sync != NULL && !device->sync(device)) {
+				failGenericDashCheckpointSave(checkpoint);
+				break;
+			}
+			checkpoint->slot = checkpoint->nextSlot;
+			checkpoint->state.sequence = checkpoint->saving.sequence;
+			checkpoint->saves++;
+			checkpoint->stage = CHECKPOINT_IDLE;
+			break;
+		}
+	}
+	return checkpoint->stage;
+}
+
+bool saveGenericDashCheckpoint(GenericDashCheckpoint* checkpoint, uint64_t now) {
+	// Finish any save already going, it has an older snapshot so another follows straight after
+	while (checkpoint->stage != CHECKPOINT_IDLE) serviceGenericDashCheckpoint(checkpoint, now);
+
+	uint32_t saves = checkpoint->saves;
+	startGenericDashCheckpointSave(checkpoint, now);
+	while (serviceGenericDashCheckpoint(checkpoint, now) != CHECKPOINT_IDLE) {
+	}
+	return checkpoint->saves != saves;
+}
+
+void resetGenericDashCheckpointSession(GenericDashCheckpoint* checkpoint) {
+	checkpoint->state.sessionFrames = 0;
+	checkpoint->changed = true;
+}
+
+float getGenericDashCheckpointMinimum(const GenericDashCheckpoint* checkpoint, GenericDashParameters param) {
+	if ((int)param < 0 || (int)param >= Generic_Dash_Parameter_Count) return NAN;
+	if (!(checkpoint->state.sessionFrames & (1 << (param / 3)))) return NAN;
+	return decodeGenericDashValue(param, checkpoint->state.minimum[param]);
+}
+
+float getGenericDashCheckpointMaximum(const GenericDashCheckpoint* checkpoint, GenericDashParameters param) {
+	if ((int)param < 0 || (int)param >= Generic_Dash_Parameter_Count) return NAN;
+	if (!(checkpoint->state.sessionFrames & (1 << (param / 3)))) return NAN;
+	return decodeGenericDashValue(param, checkpoint->state.maximum[param]);
+}
+
+size_t getGenericDashCheckpointFaults(const GenericDashCheckpoint* checkpoint, GenericDashCheckpointEvent* events, size_t maxEvents) {
+	const GenericDashCheckpointRecord* state = &checkpoint->state;
+	return copyGenericDashCheckpointEvents(state->faults, state->faultCount, state->newestFault, maxGenericDashCheckpointFaults, events, maxEvents);
+}
+
+size_t getGenericDashCheckpointLimitEvents(const GenericDashCheckpoint* checkpoint, GenericDashCheckpointEvent* events, size_t maxEvents) {
+	const GenericDashCheckpointRecord* state = &checkpoint->state;
+	return copyGenericDashCheckpointEvents(state->limitEvents, state->limitEventCount, state->newestLimitEvent, maxGenericDashCheckpointLimitEvents, events, maxEvents);
+}
+
+#ifdef GENERIC_DASH_CHECKPOINT_FILES
+
+/*
+ The file descriptor is kept in the device's user pointer
+ */
+static int getGenericDashCheckpointFileDescriptor(GenericDashCheckpointDevice* device) {
+	return (int)(intptr_t)device->user;
+}
+
+static bool readGenericDashCheckpointFile(GenericDashCheckpointDevice* device, uint32_t address, void* data, size_t length) {
+	return pread(getGenericDashCheckpointFileDescriptor(device), data, length, (off_t)address) == (ssize_t)length;
+}
+
+static bool writeGenericDashCheckpointFile(GenericDashCheckpointDevice* device, uint32_t address, const void* data, size_t length) {
+	return pwrite(getGenericDashCheckpointFileDescriptor(device), data, length, (off_t)address) == (ssize_t)length;
+}
+
+static bool syncGenericDashCheckpointFile(GenericDashCheckpointDevice* device) {
+#if defined(__APPLE__)
+	return fsync(getGenericDashCheckpointFileDescriptor(device)) == 0;
+#else
+	return fdatasync(getGenericDashCheckpointFileDescriptor(device)) == 0;
+#endif
+}
+
+bool openGenericDashCheckpointFile(GenericDashCheckpointDevice* device, const char* path, unsigned char slotCount) {
+	int fd = open(path, O_RDWR | O_CREAT, 0644);
+	if (fd < 0) return false;
+
+	memset(device, 0, sizeof(*device));
+	device->read = readGenericDashCheckpointFile;
+	device->write = writeGenericDashCheckpointFile;
+	device->sync = syncGenericDashCheckpointFile;
+	device->slotSize = sizeof(GenericDashCheckpointRecord);
+	device->slotCount = slotCount;
+	device->pageSize = sizeof(GenericDashCheckpointRecord);
+	device->user = (void*)(intptr_t)fd;
+	return true;
+}
+
+void closeGenericDashCheckpointFile(GenericDashCheckpointDevice* device) {
+	close(getGenericDashCheckpointFileDescriptor(device));
+	device->user = (void*)(intptr_t)-1;
+}
+
+#endif // GENERIC_DASH_CHECKPOINT_FILES
@@ -0,0 +1,255 @@
+/*
+ link_generic_dash_checkpoint.h - Power loss safe checkpoint of dash state and fault history
+ For copyright and license information see LICENSE
+
+ Keeps a copy of everything a dash would want back after an ignition-off or
+ brown-out, and saves it every so often so it can be shown again straight
+ away on the next boot instead of zeros:
+ - the latest raw value of every parameter, as a GenericDashContext
+ - the most recent fault codes and limit flag changes, with when they last
+   happened and how many times, so a fault that keeps coming back doesn't
+   push older, different ones out of the history
+ - the lowest and highest value of every parameter this session
+
+ Frames are parsed into the checkpoint from the CAN receive path, which only
+ updates memory. Saving happens in serviceGenericDashCheckpoint, called from
+ the main loop, which erases at most one sector or writes at most one page per
+ call so it never holds up receiving for long. Each save goes to the next of
+ several slots, each with a sequence number and a CRC-32, so a save cut short
+ by power loss only ever loses that save and writes are spread across the
+ device to even out wear.
+ The newest slot that passes its CRC is loaded at startup. Everything is kept
+ as raw values, scaled only when read, so a GenericDashCheckpointRecord is
+ about 550 bytes. A checkpoint holds two copies, one of them being the
+ snapshot that is written so a save is never torn by frames parsed mid-way.
+
+ Storage is a set of callbacks, so anything that can read and write blocks
+ will do: EEPROM or flash on a microcontroller, or on POSIX systems a file
+ with openGenericDashCheckpointFile. Some optional defines you can add before
+ including this file:
+
+ #define NO_DASH_CHECKPOINT_FILES
+ Will not include openGenericDashCheckpointFile even on POSIX systems.
+ */
+
+#ifndef link_generic_dash_checkpoint_h
+#define link_generic_dash_checkpoint_h
+
+#include "link_generic_dash.h"
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(NO_DASH_CHECKPOINT_FILES)
+#define GENERIC_DASH_CHECKPOINT_FILES
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of recent fault codes kept
+ */
+#define maxGenericDashCheckpointFaults 8
+
+/**
+ * @brief Number of recent limit flag changes kept
+ */
+#define maxGenericDashCheckpointLimitEvents 8
+
+/**
+ * @brief Default time between saves in microseconds
+ */
+#define defaultGenericDashCheckpointInterval 5000000
+
+/**
+ * @brief Marks a slot as holding a checkpoint, "GDCP"
+ */
+#define GenericDashCheckpointMagic 0x50434447UL
+
+/**
+ * @brief Bumped whenever GenericDashCheckpointRecord changes, slots from another version are ignored
+ */
+#define GenericDashCheckpointVersion 3
+
+typedef struct GenericDashCheckpointDevice GenericDashCheckpointDevice;
+
+/**
+ * @brief Storage a checkpoint is saved to, split into slotCount slots of slotSize bytes
+ */
+struct GenericDashCheckpointDevice {
+	// Return true on success. Addresses are from the start of the first slot.
+	bool (*read)(GenericDashCheckpointDevice* device, uint32_t address, void* data, size_t length);
+	bool (*write)(GenericDashCheckpointDevice* device, uint32_t address, const void* data, size_t length);
+	bool (*erase)(GenericDashCheckpointDevice* device, uint32_t address, size_t length); // Flash only, called an eraseSize block at a time before a slot is written, NULL for EEPROM or files
+	bool (*sync)(GenericDashCheckpointDevice* device); // Called once a slot is fully written, ie. to flush a file, or NULL
+	uint32_t slotSize;  // At least sizeof(GenericDashCheckpointRecord), a multiple of eraseSize for flash
+	unsigned char slotCount; // At least 2, so there is always a good slot while another is written
+	uint16_t pageSize;  // Most bytes written by a single call to write
+	uint32_t eraseSize; // Bytes erased by a single call to erase, ie. the flash sector size, 0 for the whole slot at once
+	void* user; // Anything you like, ie. the device's address
+};
+
+/**
+ * @brief Something that happened, when it last happened and how often
+ */
+typedef struct {
+	uint64_t timestamp; // Last time it happened in microseconds, as passed to parseGenericDashCheckpointCanFrame
+	uint16_t value;     // The new fault code or limit flags
+	uint16_t count;     // Number of times it has happened while in the history
+} GenericDashCheckpointEvent;
+
+/**
+ * @brief Everything saved in a slot
+ */
+typedef struct {
+	uint32_t magic;
+	uint16_t version;
+	uint16_t length;   // sizeof(GenericDashCheckpointRecord)
+	uint32_t sequence; // One more than the save before it, the highest valid one is loaded
+	uint64_t timestamp; // When it was saved
+	GenericDashContext context;
+	uint16_t minimum[Generic_Dash_Parameter_Count]; // Raw values, only set for frames in sessionFrames
+	uint16_t maximum[Generic_Dash_Parameter_Count];
+	GenericDashCheckpointEvent faults[maxGenericDashCheckpointFaults];
+	GenericDashCheckpointEvent limitEvents[maxGenericDashCheckpointLimitEvents];
+	unsigned char faultCount;
+	unsigned char newestFault;
+	unsigned char limitEventCount;
+	unsigned char newestLimitEvent;
+	uint16_t receivedFrames; // Bit n set once frame n has been received
+	uint16_t sessionFrames;  // Bit n set once frame n has been received since the session was reset
+	uint32_t crc; // CRC-32 of everything before it
+} GenericDashCheckpointRecord;
+
+/**
+ * @brief What serviceGenericDashCheckpoint is doing
+ */
+typedef enum {
+	CHECKPOINT_IDLE,    // Waiting for the next save
+	CHECKPOINT_ERASING, // Erasing the next slot
+	CHECKPOINT_WRITING, // Writing the next slot a page at a time
+} GenericDashCheckpointStages;
+
+/**
+ * @brief Live state, and the copy of it being saved
+ */
+typedef struct {
+	GenericDashCheckpointDevice* device;
+	GenericDashCheckpointRecord state; // Kept up to date by parseGenericDashCheckpointCanFrame
+	GenericDashCheckpointRecord saving; // Snapshot of state being written
+	uint64_t interval;
+	uint64_t lastSave;
+	bool changed; // state has changed since the last save started
+	GenericDashCheckpointStages stage;
+	unsigned char slot;     // Slot holding the newest checkpoint
+	unsigned char nextSlot; // Slot being written
+	uint32_t erased;  // Bytes of the slot being written erased so far
+	uint32_t written; // Bytes of the slot being written so far
+	uint32_t saves;
+	uint32_t failures; // Device calls that failed, the save is tried again next interval
+} GenericDashCheckpoint;
+
+/**
+ * @brief Sets up a checkpoint with nothing received, call loadGenericDashCheckpoint next to pick up from the last save
+ * @param checkpoint is the checkpoint to set up
+ * @param device is the storage to save to, which must outlive the checkpoint
+ * @param interval is the time between saves in microseconds, ie. defaultGenericDashCheckpointInterval
+ * @return true if set up, false if a record doesn't fit in a slot, the slots are not a multiple of eraseSize
+ * or don't fit in 32-bit addresses, or there are fewer than 2
+ */
+bool initGenericDashCheckpoint(GenericDashCheckpoint* checkpoint, GenericDashCheckpointDevice* device, uint64_t interval);
+
+/**
+ * @brief Loads the newest valid checkpoint from the device
+ * @param checkpoint is the checkpoint to load into
+ * @return true if one was loaded, false if no slot held a valid checkpoint or the device could not be read
+ */
+bool loadGenericDashCheckpoint(GenericDashCheckpoint* checkpoint);
+
+/**
+ * @brief Parse a Generic Dash CAN frame into the checkpoint, noting any new fault code or limit flags. Never touches the device.
+ * @param checkpoint is the checkpoint to update
+ * @param timestamp is when the frame was received in microseconds
+ * @param frame is an 8 unsigned char bytes CAN frame to parse
+ * @return true if successfully parsed, false otherwise
+ */
+bool parseGenericDashCheckpointCanFrame(GenericDashCheckpoint* checkpoint, uint64_t timestamp, const unsigned char frame[8]);
+
+/**
+ * @brief Carries on saving, starting a new save once the interval has passed if anything has changed
+ *
+ * Does at most one eraseSize erase or one page write per call, and only erases
+ * the sectors the record is written to. Call it regularly from the same thread
+ * that parses frames, ie. once around the main loop.
+ *
+ * @param checkpoint is the checkpoint to save
+ * @param now is the current time in microseconds, on the same clock as the frame timestamps
+ * @return GenericDashCheckpointStages what it will do on the next call, CHECKPOINT_IDLE once a save is complete
+ */
+GenericDashCheckpointStages serviceGenericDashCheckpoint(GenericDashCheckpoint* checkpoint, uint64_t now);
+
+/**
+ * @brief Saves straight away and waits until it is written, ie. when the ignition is turned off
+ * @param checkpoint is the checkpoint to save
+ * @param now is the current time in microseconds
+ * @return true if saved, false if the device failed
+ */
+bool saveGenericDashCheckpoint(GenericDashCheckpoint* checkpoint, uint64_t now);
+
+/**
+ * @brief Starts a new session, clearing the minimum and maximum values but keeping the values and history
+ * @param checkpoint is the checkpoint to change
+ */
+void resetGenericDashCheckpointSession(GenericDashCheckpoint* checkpoint);
+
+/**
+ * @brief Gets the lowest or highest value of a parameter this session
+ * @param checkpoint is the checkpoint to read
+ * @param param is one of enum GenericDashParameters to return
+ * @return float value, NAN if it hasn't been received or the parameter is unknown
+ */
+float getGenericDashCheckpointMinimum(const GenericDashCheckpoint* checkpoint, GenericDashParameters param);
+float getGenericDashCheckpointMaximum(const GenericDashCheckpoint* checkpoint, GenericDashParameters param);
+
+/**
+ * @brief Gets the most recent distinct fault codes or limit flag changes, most recently seen first
+ * @param checkpoint is the checkpoint to read
+ * @param events is filled with up to maxEvents events
+ * @param maxEvents is the size of events
+ * @return size_t number of events filled in
+ */
+size_t getGenericDashCheckpointFaults(const GenericDashCheckpoint* checkpoint, GenericDashCheckpointEvent* events, size_t maxEvents);
+size_t getGenericDashCheckpointLimitEvents(const GenericDashCheckpoint* checkpoint, GenericDashCheckpointEvent* events, size_t maxEvents);
+
+/**
+ * @brief Calculates a CRC-32 (as used by zip and Ethernet)
+ * @param crc is 0 to start, or the result of the previous call to carry on
+ * @param data is the data to add
+ * @param length is the length of data
+ * @return uint32_t CRC-32 of everything so far
+ */
+uint32_t crcGenericDashCheckpoint(uint32_t crc, const void* data, size_t length);
+
+#ifdef GENERIC_DASH_CHECKPOINT_FILES
+
+/**
+ * @brief Sets up a device that saves to a file, created if it doesn't exist
+ * @param device is the device to set up, close it with closeGenericDashCheckpointFile
+ * @param path is the file to save to
+ * @param slotCount is the number of slots, at least 2
+ * @return true if the file was opened, false otherwise
+ */
+bool openGenericDashCheckpointFile(GenericDashCheckpointDevice* device, const char* path, unsigned char slotCount);
+
+/**
+ * @brief Closes a file opened by openGenericDashCheckpointFile
+ * @param device is the device to close
+ */
+void closeGenericDashCheckpointFile(GenericDashCheckpointDevice* device);
+
+#endif // GENERIC_DASH_CHECKPOINT_FILES
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // link_generic_dash_checkpoint_h
@@ -0,0 +1,223 @@
+/*
+ Any additions to this file will need suitable additions to link_generic_dash_counters.h
+ For documentation please the above file.
+ */
+
+#include "link_generic_dash_counters.h"
+
+#ifndef NO_DASH_COUNTERS
+
+#include <stdarg.h>
+
+/*
+ Only one thread counts into a set of counters, so a relaxed load and store is
+ enough and avoids the locked read-modify-write a fetch-add costs. Snapshots
+ from other threads still never see a torn value. AVR has no 64-bit atomics,
+ so a snapshot there reads each counter with interrupts off in case it is
+ being counted into from an interrupt handler.
+ */
+#if defined(__AVR__)
+#include <avr/interrupt.h>
+static inline uint64_t loadGenericDashCounter(const GenericDashCounter* counter) {
+	uint8_t state = SREG;
+	cli();
+	uint64_t value = *(const volatile GenericDashCounter*)counter;
+	SREG = state;
+	return value;
+}
+#define addGenericDashCounter(counter, amount) (*(volatile GenericDashCounter*)&(counter) += (amount))
+#define readGenericDashCounter(counter) loadGenericDashCounter(&(counter))
+#define storeGenericDashCounter(counter, value) (*(volatile GenericDashCounter*)&(counter) = (value))
+#elif defined(__GNUC__)
+#define addGenericDashCounter(counter, amount) __atomic_store_n(&(counter), __atomic_load_n(&(counter), __ATOMIC_RELAXED) + (amount), __ATOMIC_RELAXED)
+#define readGenericDashCounter(counter) __atomic_load_n(&(counter), __ATOMIC_RELAXED)
+#define storeGenericDashCounter(counter, value) __atomic_store_n(&(counter), (value), __ATOMIC_RELAXED)
+#else
+#define addGenericDashCounter(counter, amount) (*(volatile GenericDashCounter*)&(counter) += (amount))
+#define readGenericDashCounter(counter) (*(const volatile GenericDashCounter*)&(counter))
+#define storeGenericDashCounter(counter, value) (*(volatile GenericDashCounter*)&(counter) = (value))
+#endif
+
+#ifdef GENERIC_DASH_COUNT_CYCLES
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+static inline uint64_t readGenericDashCycles(void) {
+	return __rdtsc();
+}
+#elif defined(__aarch64__)
+static inline uint64_t readGenericDashCycles(void) {
+	uint64_t ticks;
+	__asm__ volatile("mrs %0, cntvct_el0" : "=r"(ticks));
+	return ticks;
+}
+#else
+#error "GENERIC_DASH_COUNT_CYCLES is only supported on x86 and 64-bit ARM"
+#endif
+#endif // GENERIC_DASH_COUNT_CYCLES
+
+const uint32_t GenericDashIntervalBucketBounds[Generic_Dash_Interval_Bucket_Count - 1] = {
+	1000, 2000, 5000, 10000, 20000, 50000, 100000, 200000, 500000, 1000000, 2000000
+};
+
+/*
+ Prometheus "le" labels for the above, in seconds
+ */
+static const char *GenericDashIntervalBucketLabels[Generic_Dash_Interval_Bucket_Count] = {
+	"0.001", "0.002", "0.005", "0.01", "0.02", "0.05", "0.1", "0.2", "0.5", "1", "2", "+Inf"
+};
+
+void initGenericDashCounters(GenericDashCounters* counters) {
+	memset(counters, 0, sizeof(*counters));
+}
+
+bool parseGenericDashCountedCanFrame(GenericDashContext* context, GenericDashCounters* counters, const unsigned char frame[8], uint64_t timestamp) {
+#ifdef GENERIC_DASH_COUNT_CYCLES
+	uint64_t started = readGenericDashCycles();
+	bool accepted = parseGenericDashContextCanFrame(context, frame);
+	addGenericDashCounter(counters->parseCycles, readGenericDashCycles() - started);
+	addGenericDashCounter(counters->parseCount, 1);
+#else
+	bool accepted = parseGenericDashContextCanFrame(context, frame);
+#endif
+
+	if (!accepted) {
+		if (frame[0] >= Generic_Dash_Frame_Count) addGenericDashCounter(counters->framesRejectedIndex, 1);
+		else addGenericDashCounter(counters->framesRejectedReserved, 1);
+		return false;
+	}
+	addGenericDashCounter(counters->framesAccepted, 1);
+
+	unsigned char index = frame[0];
+	if (readGenericDashCounter(counters->frameArrivals[index]) == 0) {
+		storeGenericDashCounter(counters->firstArrival[index], timestamp);
+	} else {
+		uint64_t previous = readGenericDashCounter(counters->lastArrival[index]);
+		if (timestamp >= previous) {
+			uint64_t interval = timestamp - previous;
+			int bucket = 0;
+			while (bucket < Generic_Dash_Interval_Bucket_Count - 1 && interval > GenericDashIntervalBucketBounds[bucket]) bucket++;
+			addGenericDashCounter(counters->intervalBuckets[index][bucket], 1);
+			addGenericDashCounter(counters->intervalTotal[index], interval);
+		}
+	}
+	storeGenericDashCounter(counters->lastArrival[index], timestamp);
+	addGenericDashCounter(counters->frameArrivals[index], 1);
+	return true;
+}
+
+float getGenericDashCountedValue(const GenericDashContext* context, GenericDashCounters* counters, GenericDashParameters param) {
+#ifdef GENERIC_DASH_COUNT_CYCLES
+	uint64_t started = readGenericDashCycles();
+	float value = getGenericDashContextValue(context, param);
+	addGenericDashCounter(counters->decodeCycles, readGenericDashCycles() - started);
+	addGenericDashCounter(counters->decodeCount, 1);
+	return value;
+#else
+	(void)counters;
+	return getGenericDashContextValue(context, param);
+#endif
+}
+
+void snapshotGenericDashCounters(const GenericDashCounters* counters, GenericDashCountersSnapshot* snapshot) {
+	memset(snapshot, 0, sizeof(*snapshot));
+	snapshot->framesAccepted = readGenericDashCounter(counters->framesAccepted);
+	snapshot->framesRejectedIndex = readGenericDashCounter(counters->framesRejectedIndex);
+	snapshot->framesRejectedReserved = readGenericDashCounter(counters->framesRejectedReserved);
+
+	for (int i = 0; i < Generic_Dash_Frame_Count; i++) {
+		snapshot->frameArrivals[i] = readGenericDashCounter(counters->frameArrivals[i]);
+		uint64_t first = readGenericDashCounter(counters->firstArrival[i]);
+		uint64_t last = readGenericDashCounter(counters->lastArrival[i]);
+		if (snapshot->frameArrivals[i] > 1 && last > first)
+			snapshot->frameRateHz[i] = (float)((double)(snapshot->frameArrivals[i] - 1) * 1000000.0 / (double)(last - first));
+		for (int j = 0; j < Generic_Dash_Interval_Bucket_Count; j++)
+			snapshot->intervalBuckets[i][j] = readGenericDashCounter(counters->intervalBuckets[i][j]);
+		snapshot->intervalTotal[i] = readGenericDashCounter(counters->intervalTotal[i]);
+	}
+
+	snapshot->parseCycles = readGenericDashCounter(counters->parseCycles);
+	snapshot->parseCount = readGenericDashCounter(counters->parseCount);
+	snapshot->decodeCycles = readGenericDashCounter(counters->decodeCycles);
+	snapshot->decodeCount = readGenericDashCounter(counters->decodeCount);
+}
+
+static bool appendGenericDashPrometheus(char* output, size_t outputSize, size_t* length, const char* format, ...) {
+	if (*length >= outputSize) return false;
+	va_list arguments;
+	va_start(arguments, format);
+	int written = vsnprintf(output + *length, outputSize - *length, format, arguments);
+	va_end(arguments);
+	if (written < 0 || (size_t)written >= outputSize - *length) {
+		*length = outputSize;
+		return false;
+	}
+	*length += (size_t)written;
+	return true;
+}
+
+size_t renderGenericDashCountersPrometheus(const GenericDashCountersSnapshot* snapshot, const char* labels, char* output, size_t outputSize) {
+	size_t length = 0;
+	const char* extra = (labels != NULL && labels[0] != 0) ? labels : "";
+	const char* separator = extra[0] ? "," : "";
+
+	appendGenericDashPrometheus(output, outputSize, &length,
+		"# HELP link_generic_dash_frames_total Generic Dash frames parsed, by result.\n"
+		"# TYPE link_generic_dash_frames_total counter\n"
+		"link_generic_dash_frames_total{%s%sresult=\"accepted\"} %llu\n"
+		"link_generic_dash_frames_total{%s%sresult=\"rejected\",reason=\"bad_index\"} %llu\n"
+		"link_generic_dash_frames_total{%s%sresult=\"rejected\",reason=\"bad_reserved_byte\"} %llu\n",
+		extra, separator, (unsigned long long)snapshot->framesAccepted,
+		extra, separator, (unsigned long long)snapshot->framesRejectedIndex,
+		extra, separator, (unsigned long long)snapshot->framesRejectedReserved);
+
+	appendGenericDashPrometheus(output, outputSize, &length,
+		"# HELP link_generic_dash_frame_arrivals_total Accepted Generic Dash frames, by frame index.\n"
+		"# TYPE link_generic_dash_frame_arrivals_total counter\n");
+	for (int i = 0; i < Generic_Dash_Frame_Count; i++)
+		appendGenericDashPrometheus(output, outputSize, &length, "link_generic_dash_frame_arrivals_total{%s%sframe=\"%d\"} %llu\n",
+			extra, separator, i, (unsigned long long)snapshot->frameArrivals[i]);
+
+	appendGenericDashPrometheus(output, outputSize, &length,
+		"# HELP link_generic_dash_frame_rate_hz Average arrival rate of each frame index since it was first seen.\n"
+		"# TYPE link_generic_dash_frame_rate_hz gauge\n");
+	for (int i = 0; i < Generic_Dash_Frame_Count; i++)
+		appendGenericDashPrometheus(output, outputSize, &length, "link_generic_dash_frame_rate_hz{%s%sframe=\"%d\"} %.3f\n",
+			extra, separator, i, (double)snapshot->frameRateHz[i]);
+
+	appendGenericDashPrometheus(output, outputSize, &length,
+		"# HELP link_generic_dash_frame_interval_seconds Time between arrivals of each frame index.\n"
+		"# TYPE link_generic_dash_frame_interval_seconds histogram\n");
+	for (int i = 0; i < Generic_Dash_Frame_Count; i++) {
+		uint64_t cumulative = 0;
+		for (int j = 0; j < Generic_Dash_Interval_Bucket_Count; j++) {
+			cumulative += snapshot->intervalBuckets[i][j];
+			appendGenericDashPrometheus(output, outputSize, &length, "link_generic_dash_frame_interval_seconds_bucket{%s%sframe=\"%d\",le=\"%s\"} %llu\n",
+				extra, separator, i, GenericDashIntervalBucketLabels[j], (unsigned long long)cumulative);
+		}
+		appendGenericDashPrometheus(output, outputSize, &length,
+			"link_generic_dash_frame_interval_seconds_sum{%s%sframe=\"%d\"} %.6f\n"
+			"link_generic_dash_frame_interval_seconds_count{%s%sframe=\"%d\"} %llu\n",
+			extra, separator, i, (double)snapshot->intervalTotal[i] / 1000000.0,
+			extra, separator, i, (unsigned long long)cumulative);
+	}
+
+#ifdef GENERIC_DASH_COUNT_CYCLES
+	appendGenericDashPrometheus(output, outputSize, &length,
+		"# HELP link_generic_dash_cycles_total CPU cycles spent, by operation.\n"
+		"# TYPE link_generic_dash_cycles_total counter\n"
+		"link_generic_dash_cycles_total{%s%soperation=\"parse\"} %llu\n"
+		"link_generic_dash_cycles_total{%s%soperation=\"decode\"} %llu\n"
+		"# HELP link_generic_dash_operations_total Operations timed for link_generic_dash_cycles_total.\n"
+		"# TYPE link_generic_dash_operations_total counter\n"
+		"link_generic_dash_operations_total{%s%soperation=\"parse\"} %llu\n"
+		"link_generic_dash_operations_total{%s%soperation=\"decode\"} %llu\n",
+		extra, separator, (unsigned long long)snapshot->parseCycles,
+		extra, separator, (unsigned long long)snapshot->decodeCycles,
+		extra, separator, (unsigned long long)snapshot->parseCount,
+		extra, separator, (unsigned long long)snapshot->decodeCount);
+#endif
+
+	return length < outputSize ? length : 0;
+}
+
+#endif // NO_DASH_COUNTERS
@@ -0,0 +1,144 @@
+/*
+ link_generic_dash_counters.h - Decoder instrumentation and Prometheus exporter
+ For copyright and license information see LICENSE
+
+ Counts what a decoder sees so a bus that starts dropping or corrupting frames
+ can be spotted: frames accepted, frames rejected and why, how often each of
+ the 14 frames arrives and a histogram of the time between arrivals. Counting
+ is a handful of relaxed atomic increments per frame. Each set of counters
+ should only be counted into by one thread, the one parsing into its context,
+ but can be snapshotted from any other thread at any time. The counters are
+ plain 64-bit integers laid out the same from C, C++ and on every target, and
+ are only ever touched through the functions below, which do the atomic
+ accesses, so read them with snapshotGenericDashCounters rather than directly.
+
+ Some optional defines you can add before including this file:
+
+ #define NO_DASH_COUNTERS
+ parseGenericDashCountedCanFrame and getGenericDashCountedValue become plain
+ parseGenericDashContextCanFrame and getGenericDashContextValue calls, so
+ instrumented code costs nothing when counters aren't wanted. The snapshot and
+ Prometheus functions are not available.
+
+ #define GENERIC_DASH_COUNT_CYCLES
+ Also counts CPU cycles spent parsing and decoding, on x86 and 64-bit ARM.
+ Only needs defining where link_generic_dash_counters.c is compiled, the
+ counters are laid out the same either way and the cycle counts stay 0
+ without it.
+ */
+
+#ifndef link_generic_dash_counters_h
+#define link_generic_dash_counters_h
+
+#include "link_generic_dash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief A single counter or timestamp, 64 bits on every target
+ */
+typedef uint64_t GenericDashCounter;
+
+/**
+ * @brief Number of buckets in each frame's arrival interval histogram, including +Inf
+ */
+#define Generic_Dash_Interval_Bucket_Count 12
+
+/**
+ * @brief Live counters for a single decoder context
+ */
+typedef struct {
+	GenericDashCounter framesAccepted;
+	GenericDashCounter framesRejectedIndex;    // frame[0] >= 14
+	GenericDashCounter framesRejectedReserved; // frame[1] != 0
+	GenericDashCounter frameArrivals[Generic_Dash_Frame_Count];
+	GenericDashCounter firstArrival[Generic_Dash_Frame_Count];
+	GenericDashCounter lastArrival[Generic_Dash_Frame_Count];
+	GenericDashCounter intervalBuckets[Generic_Dash_Frame_Count][Generic_Dash_Interval_Bucket_Count];
+	GenericDashCounter intervalTotal[Generic_Dash_Frame_Count];
+	GenericDashCounter parseCycles; // Only counted with GENERIC_DASH_COUNT_CYCLES
+	GenericDashCounter parseCount;
+	GenericDashCounter decodeCycles;
+	GenericDashCounter decodeCount;
+} GenericDashCounters;
+
+#ifdef NO_DASH_COUNTERS
+
+#define parseGenericDashCountedCanFrame(context, counters, frame, timestamp) parseGenericDashContextCanFrame((context), (frame))
+#define getGenericDashCountedValue(context, counters, param) getGenericDashContextValue((context), (param))
+
+#else
+
+/**
+ * @brief A copy of a set of counters at a point in time
+ */
+typedef struct {
+	uint64_t framesAccepted;
+	uint64_t framesRejectedIndex;
+	uint64_t framesRejectedReserved;
+	uint64_t frameArrivals[Generic_Dash_Frame_Count];
+	float frameRateHz[Generic_Dash_Frame_Count]; // Average since each frame was first seen
+	uint64_t intervalBuckets[Generic_Dash_Frame_Count][Generic_Dash_Interval_Bucket_Count];
+	uint64_t intervalTotal[Generic_Dash_Frame_Count]; // Microseconds
+	uint64_t parseCycles;
+	uint64_t parseCount;
+	uint64_t decodeCycles;
+	uint64_t decodeCount;
+} GenericDashCountersSnapshot;
+
+/**
+ * @brief Upper bound of each arrival interval bucket in microseconds, the last bucket is +Inf
+ */
+extern const uint32_t GenericDashIntervalBucketBounds[Generic_Dash_Interval_Bucket_Count - 1];
+
+/**
+ * @brief Clear a set of counters ready for use
+ * @param counters is the set of counters to clear
+ */
+void initGenericDashCounters(GenericDashCounters* counters);
+
+/**
+ * @brief Parse a CAN frame into a decoder context and count the result
+ * @param context is the decoder context to parse into
+ * @param counters is the set of counters to update
+ * @param frame is an 8 unsigned char bytes CAN frame to decode
+ * @param timestamp is when the frame was received in microseconds
+ * @return true if successfully decoded, false otherwise
+ */
+bool parseGenericDashCountedCanFrame(GenericDashContext* context, GenericDashCounters* counters, const unsigned char frame[8], uint64_t timestamp);
+
+/**
+ * @brief Same as getGenericDashContextValue, counting cycles if GENERIC_DASH_COUNT_CYCLES is defined
+ * @param context is the decoder context to read
+ * @param counters is the set of counters to update
+ * @param param is one of enum GenericDashParameters to return
+ * @return float value of the requested parameter
+ */
+float getGenericDashCountedValue(const GenericDashContext* context, GenericDashCounters* counters, GenericDashParameters param);
+
+/**
+ * @brief Copy a set of counters, safe to call while another thread is counting
+ * @param counters is the set of counters to copy
+ * @param snapshot is filled with the current counts
+ */
+void snapshotGenericDashCounters(const GenericDashCounters* counters, GenericDashCountersSnapshot* snapshot);
+
+/**
+ * @brief Renders a snapshot in the Prometheus text exposition format
+ * @param snapshot is the snapshot to render
+ * @param labels are extra labels added to every metric ie. "bus=\"can0\"", or NULL
+ * @param output is a char array that will get filled with the metrics, 32 KB is plenty
+ * @param outputSize is the size of output
+ * @return size_t number of bytes written to output, 0 if it didn't fit
+ */
+size_t renderGenericDashCountersPrometheus(const GenericDashCountersSnapshot* snapshot, const char* labels, char* output, size_t outputSize);
+
+#endif // NO_DASH_COUNTERS
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // link_generic_dash_counters_h
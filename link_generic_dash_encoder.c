@@ -0,0 +1,105 @@
+/*
+ Any additions to this file will need suitable additions to link_generic_dash_encoder.h
+ For documentation please the above file.
+ */
+
+#include "link_generic_dash_encoder.h"
+
+#include <math.h>
+
+static bool setGenericDashEncoderWord(GenericDashEncoder* encoder, int param, uint16_t rawValue) {
+	if (encoder->context.words[param] != rawValue) {
+		encoder->context.words[param] = rawValue;
+		encoder->dirty = (uint16_t)(encoder->dirty | (1u << (param / 3)));
+	}
+	return true;
+}
+
+void initGenericDashEncoder(GenericDashEncoder* encoder) {
+	initGenericDashContext(&encoder->context);
+	encoder->dirty = allGenericDashFrames;
+}
+
+bool setGenericDashEncoderValue(GenericDashEncoder* encoder, GenericDashParameters param, float value) {
+	if ((int)param < 0 || (int)param >= Generic_Dash_Parameter_Count || isnan(value)) return false;
+
+	/*
+	 Scaling is worked out from decodeGenericDashValue itself so the two can't
+	 disagree. Every parameter is a straight line through raw 0, apart from the
+	 rounding in ignition timing, so the first guess is within one of the best
+	 raw value and its neighbours are checked for an exact match.
+	 */
+	float lowest = decodeGenericDashValue(param, 0);
+	float highest = decodeGenericDashValue(param, UINT16_MAX);
+	if (value < (lowest < highest ? lowest : highest) || value > (lowest < highest ? highest : lowest)) return false;
+
+	double slope = ((double)decodeGenericDashValue(param, 1000) - lowest) / 1000.0;
+	double guess = round(((double)value - lowest) / slope);
+	long best = guess < 0 ? 0 : guess > UINT16_MAX ? UINT16_MAX : (long)guess;
+	float bestError = fabsf(decodeGenericDashValue(param, (uint16_t)best) - value);
+	for (long raw = best - 1; raw <= best + 1 && bestError != 0; raw += 2) {
+		if (raw < 0 || raw > UINT16_MAX) continue;
+		float error = fabsf(decodeGenericDashValue(param, (uint16_t)raw) - value);
+		if (error < bestError) {
+			best = raw;
+			bestError = error;
+		}
+	}
+	return setGenericDashEncoderWord(encoder, param, (uint16_t)best);
+}
+
+bool setGenericDashEncoderRawValue(GenericDashEncoder* encoder, GenericDashParameters param, uint16_t rawValue) {
+	if ((int)param < 0 || (int)param >= Generic_Dash_Parameter_Count) return false;
+	return setGenericDashEncoderWord(encoder, param, rawValue);
+}
+
+bool setGenericDashEncoderLimitFlag(GenericDashEncoder* encoder, GenericDashLimitFlags param, bool active) {
+	if ((int)param < 0 || (int)param >= Generic_Dash_Limit_Flag_Count) return false;
+	uint16_t flags = encoder->context.words[ECU_LIMIT_FLAGS_BITFIELD];
+	// Unsigned so flag 15 doesn't shift into the sign bit of a 16-bit int on AVR
+	uint16_t mask = (uint16_t)(1u << param);
+	flags = active ? (uint16_t)(flags | mask) : (uint16_t)(flags & ~mask);
+	return setGenericDashEncoderWord(encoder, ECU_LIMIT_FLAGS_BITFIELD, flags);
+}
+
+bool setGenericDashEncoderFeatureStatus(GenericDashEncoder* encoder, GenericDashFeatureStatuses param, unsigned char state) {
+	unsigned int shift, mask, count;
+	switch (param) {
+		case STATUS_ANTI_LAG:
+			shift = 0x5; mask = 0x7; count = Generic_Dash_States_AntiLag_Count;
+			break;
+		case STATUS_LAUNCH_CONTROL:
+			shift = 0x3; mask = 0x3; count = Generic_Dash_States_Launch_Control_Count;
+			break;
+		case STATUS_TRACTION_CONTROL:
+			shift = 0x0; mask = 0x7; count = Generic_Dash_States_Traction_Control_Count;
+			break;
+		case STATUS_CRUISE_CONTROL:
+			shift = 0xC; mask = 0x7; count = Generic_Dash_States_Cruise_Control_Count;
+			break;
+		default:
+			return false;
+	}
+	if (state >= count) return false;
+	uint16_t statuses = encoder->context.words[ECU_STATUS_BITFIELD];
+	statuses = (uint16_t)((statuses & ~(mask << shift)) | ((unsigned int)state << shift));
+	return setGenericDashEncoderWord(encoder, ECU_STATUS_BITFIELD, statuses);
+}
+
+void setGenericDashEncoderContext(GenericDashEncoder* encoder, const GenericDashContext* context) {
+	for (int i = 0; i < Generic_Dash_Parameter_Count; i++) setGenericDashEncoderWord(encoder, i, context->words[i]);
+}
+
+void markGenericDashEncoderFrames(GenericDashEncoder* encoder, uint16_t frames) {
+	encoder->dirty |= frames & allGenericDashFrames;
+}
+
+size_t emitGenericDashEncoderFrames(GenericDashEncoder* encoder, unsigned char frames[][8], size_t maxFrames) {
+	size_t emitted = 0;
+	for (unsigned char index = 0; index < Generic_Dash_Frame_Count && emitted < maxFrames && encoder->dirty; index++) {
+		if (!(encoder->dirty & (1u << index))) continue;
+		encodeGenericDashContextCanFrame(&encoder->context, index, frames[emitted++]);
+		encoder->dirty = (uint16_t)(encoder->dirty & ~(1u << index));
+	}
+	return emitted;
+}
@@ -0,0 +1,108 @@
+/*
+ link_generic_dash_encoder.h - Builds a Generic Dash stream, the reverse of the decoder
+ For copyright and license information see LICENSE
+
+ For gateways and bridges that need to send Generic Dash themselves, ie. a
+ stream merged with values from a second sensor box, or re-scaled for a third
+ party dash that expects a Link ECU. Parameters, limit flags and feature
+ states are set in an encoder, which keeps track of which of the 14 frames
+ have changed since they were last sent. Only those are emitted, straight
+ into a buffer you provide.
+
+ Values are converted back to the raw value the ECU would have sent, so a
+ value read with getGenericDashValue and set on an encoder comes out of a
+ decoder exactly the same at the other end.
+ */
+
+#ifndef link_generic_dash_encoder_h
+#define link_generic_dash_encoder_h
+
+#include "link_generic_dash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Mask of every frame, for markGenericDashEncoderFrames
+ */
+#define allGenericDashFrames ((1 << Generic_Dash_Frame_Count) - 1)
+
+/**
+ * @brief Values to send and which frames need sending
+ */
+typedef struct {
+	GenericDashContext context; // Values as they will be sent
+	uint16_t dirty; // Bit n set if frame n has changed since it was last emitted
+} GenericDashEncoder;
+
+/**
+ * @brief Sets up an encoder with every raw value at 0 and every frame waiting to be sent
+ * @param encoder is the encoder to set up
+ */
+void initGenericDashEncoder(GenericDashEncoder* encoder);
+
+/**
+ * @brief Set a parameter, rounded to the nearest value the ECU can send
+ * @param encoder is the encoder to change
+ * @param param is one of enum GenericDashParameters to set
+ * @param value is the value as getGenericDashValue would return it
+ * @return true if set, false if the parameter is unknown or the value is out of range
+ */
+bool setGenericDashEncoderValue(GenericDashEncoder* encoder, GenericDashParameters param, float value);
+
+/**
+ * @brief Set the raw value of a parameter as sent by the ECU, before any scaling
+ * @param encoder is the encoder to change
+ * @param param is one of enum GenericDashParameters to set
+ * @param rawValue is the raw value to send
+ * @return true if set, false otherwise
+ */
+bool setGenericDashEncoderRawValue(GenericDashEncoder* encoder, GenericDashParameters param, uint16_t rawValue);
+
+/**
+ * @brief Set or clear a single limit flag
+ * @param encoder is the encoder to change
+ * @param param is one of enum GenericDashLimitFlags to set
+ * @param active is whether the limit is active
+ * @return true if set, false otherwise
+ */
+bool setGenericDashEncoderLimitFlag(GenericDashEncoder* encoder, GenericDashLimitFlags param, bool active);
+
+/**
+ * @brief Set the state of a single feature
+ * @param encoder is the encoder to change
+ * @param param is one of enum GenericDashFeatureStatuses to set
+ * @param state is one of the matching GenericDashStates enum
+ * @return true if set, false if the feature or state is unknown
+ */
+bool setGenericDashEncoderFeatureStatus(GenericDashEncoder* encoder, GenericDashFeatureStatuses param, unsigned char state);
+
+/**
+ * @brief Set every value at once from a decoder context, ie. to re-send a stream after changing a few values
+ * @param encoder is the encoder to change
+ * @param context is the decoder context to copy
+ */
+void setGenericDashEncoderContext(GenericDashEncoder* encoder, const GenericDashContext* context);
+
+/**
+ * @brief Marks frames as needing to be sent even if they haven't changed, ie. for a periodic refresh
+ * @param encoder is the encoder to change
+ * @param frames is a mask with bit n set for frame n, or allGenericDashFrames
+ */
+void markGenericDashEncoderFrames(GenericDashEncoder* encoder, uint16_t frames);
+
+/**
+ * @brief Emits every frame that needs sending, lowest index first
+ * @param encoder is the encoder to emit from
+ * @param frames is an array of 8 unsigned char bytes CAN frames to fill
+ * @param maxFrames is the size of frames, any frames that don't fit are left for the next call
+ * @return size_t number of frames emitted
+ */
+size_t emitGenericDashEncoderFrames(GenericDashEncoder* encoder, unsigned char frames[][8], size_t maxFrames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // link_generic_dash_encoder_h
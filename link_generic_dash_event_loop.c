@@ -0,0 +1,465 @@
+/*
+ Any additions to this file will need suitable additions to link_generic_dash_event_loop.h
+ For documentation please the above file.
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#include "link_generic_dash_event_loop.h"
+
+#ifdef __linux__
+
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/epoll.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#ifdef GENERIC_DASH_IO_URING
+#include <linux/io_uring.h>
+#endif
+
+#define GenericDashEventLoopBatch 32
+#define GenericDashEventLoopControlSize CMSG_SPACE(sizeof(struct timespec))
+
+static uint64_t linkGenericDashReceiveTimestamp(struct msghdr* message) {
+	for (struct cmsghdr* control = CMSG_FIRSTHDR(message); control != NULL; control = CMSG_NXTHDR(message, control)) {
+		if (control->cmsg_level == SOL_SOCKET && control->cmsg_type == SCM_TIMESTAMPNS) {
+			struct timespec received;
+			memcpy(&received, CMSG_DATA(control), sizeof(received));
+			return (uint64_t)received.tv_sec * 1000000 + received.tv_nsec / 1000;
+		}
+	}
+
+	// Socket doesn't support receive timestamps, now is the next best thing
+	struct timespec now;
+	clock_gettime(CLOCK_REALTIME, &now);
+	return (uint64_t)now.tv_sec * 1000000 + now.tv_nsec / 1000;
+}
+
+static int deliverGenericDashBusFrame(GenericDashBus* bus, const struct can_frame* frame, size_t length, uint64_t timestamp) {
+	if (length < CAN_MTU || (frame->can_id & (CAN_RTR_FLAG | CAN_ERR_FLAG)) || frame->can_dlc != 8) return 0;
+	canid_t canId = frame->can_id & ((frame->can_id & CAN_EFF_FLAG) ? CAN_EFF_MASK : CAN_SFF_MASK);
+	if (canId != bus->canId) return 0;
+
+	GenericDashRecord record;
+	record.timestamp = timestamp;
+	memcpy(record.frame, frame->data, 8);
+	bool accepted = bus->counters != NULL
+		? parseGenericDashCountedCanFrame(bus->context, bus->counters, record.frame, timestamp)
+		: parseGenericDashContextCanFrame(bus->context, record.frame);
+	if (bus->callback != NULL) bus->callback(bus, &record, accepted);
+	return 1;
+}
+
+/*
+ epoll backend - wait for any bus to be readable, then drain it in batches
+ */
+static int receiveGenericDashBusFrames(GenericDashBus* bus) {
+	struct mmsghdr messages[GenericDashEventLoopBatch];
+	struct iovec vectors[GenericDashEventLoopBatch];
+	struct can_frame frames[GenericDashEventLoopBatch];
+	// CMSG_SPACE is a whole number of cmsghdr alignments, so aligning the first buffer aligns them all
+	_Alignas(struct cmsghdr) char controls[GenericDashEventLoopBatch][GenericDashEventLoopControlSize];
+	int delivered = 0;
+
+	for (;;) {
+		memset(messages, 0, sizeof(messages));
+		for (int i = 0; i < GenericDashEventLoopBatch; i++) {
+			vectors[i].iov_base = &frames[i];
+			vectors[i].iov_len = sizeof(frames[i]);
+			messages[i].msg_hdr.msg_iov = &vectors[i];
+			messages[i].msg_hdr.msg_iovlen = 1;
+			messages[i].msg_hdr.msg_control = controls[i];
+			messages[i].msg_hdr.msg_controllen = sizeof(controls[i]);
+		}
+
+		int received = recvmmsg(bus->socketFd, messages, GenericDashEventLoopBatch, MSG_DONTWAIT, NULL);
+		if (received <= 0) break;
+		for (int i = 0; i < received; i++)
+			delivered += deliverGenericDashBusFrame(bus, &frames[i], messages[i].msg_len, linkGenericDashReceiveTimestamp(&messages[i].msg_hdr));
+		if (received < GenericDashEventLoopBatch) break;
+	}
+	return delivered;
+}
+
+static int runGenericDashEventLoopEpoll(GenericDashEventLoop* loop, int timeoutMs) {
+	struct epoll_event events[maxGenericDashEventLoopBuses];
+	int ready = epoll_wait(loop->epollFd, events, maxGenericDashEventLoopBuses, timeoutMs);
+	if (ready < 0) return errno == EINTR ? 0 : -1;
+
+	int delivered = 0;
+	for (int i = 0; i < ready; i++) delivered += receiveGenericDashBusFrames(&loop->buses[events[i].data.u32]);
+	return delivered;
+}
+
+#ifdef GENERIC_DASH_IO_URING
+
+/*
+ io_uring backend - every bus has a multishot recvmsg armed, which keeps
+ completing into buffers from a ring shared with the kernel until it runs
+ out of buffers. This talks to the kernel directly so there is no liburing
+ dependency.
+ */
+#define GenericDashRingEntries 32
+#define GenericDashRingBuffers 256
+#define GenericDashRingBufferSize 128
+#define GenericDashRingBufferGroup 0
+#define GenericDashRingProbe UINT64_MAX // user_data of the receive armed by probeGenericDashEventLoopRing
+#define GenericDashRingCancel (UINT64_MAX - 1)
+
+// The kernel lays out each buffer as io_uring_recvmsg_out, the control messages this asks for, then the frame
+static const struct msghdr GenericDashRingMessage = { .msg_controllen = GenericDashEventLoopControlSize };
+
+static int enterGenericDashEventLoopRing(GenericDashEventLoopRing* ring, unsigned int wait, int timeoutMs) {
+	struct __kernel_timespec timeout = { timeoutMs / 1000, (timeoutMs % 1000) * 1000000LL };
+	struct io_uring_getevents_arg argument;
+	memset(&argument, 0, sizeof(argument));
+	if (timeoutMs >= 0) argument.ts = (uint64_t)(uintptr_t)&timeout;
+
+	int submitted = (int)syscall(__NR_io_uring_enter, ring->ringFd, ring->pendingSubmissions, wait,
+		IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG, &argument, sizeof(argument));
+	if (submitted < 0) return (errno == ETIME || errno == EINTR) ? 0 : -1;
+	ring->pendingSubmissions -= (unsigned int)submitted;
+	return 0;
+}
+
+static void recycleGenericDashRingBuffer(GenericDashEventLoopRing* ring, unsigned short id) {
+	struct io_uring_buf_ring* bufferRing = (struct io_uring_buf_ring*)ring->bufferRing;
+	struct io_uring_buf* buffer = &bufferRing->bufs[ring->bufferTail & (GenericDashRingBuffers - 1)];
+	buffer->addr = (uint64_t)(uintptr_t)(ring->bufferMemory + id * GenericDashRingBufferSize);
+	buffer->len = GenericDashRingBufferSize;
+	buffer->bid = id;
+	ring->bufferTail++;
+}
+
+static void publishGenericDashRingBuffers(GenericDashEventLoopRing* ring) {
+	struct io_uring_buf_ring* bufferRing = (struct io_uring_buf_ring*)ring->bufferRing;
+	__atomic_store_n(&bufferRing->tail, ring->bufferTail, __ATOMIC_RELEASE);
+}
+
+static void armGenericDashRingReceive(GenericDashEventLoopRing* ring, int socketFd, uint64_t userData) {
+	unsigned int tail = *ring->submissionTail;
+	unsigned int index = tail & ring->submissionMask;
+	struct io_uring_sqe* entry = &((struct io_uring_sqe*)ring->submissionEntries)[index];
+
+	memset(entry, 0, sizeof(*entry));
+	entry->opcode = IORING_OP_RECVMSG;
+	entry->fd = socketFd;
+	entry->addr = (uint64_t)(uintptr_t)&GenericDashRingMessage;
+	entry->ioprio = IORING_RECV_MULTISHOT;
+	entry->flags = IOSQE_BUFFER_SELECT;
+	entry->buf_group = GenericDashRingBufferGroup;
+	entry->user_data = userData;
+
+	ring->submissionArray[index] = index;
+	__atomic_store_n(ring->submissionTail, tail + 1, __ATOMIC_RELEASE);
+	ring->pendingSubmissions++;
+}
+
+static void armGenericDashRingBus(GenericDashEventLoop* loop, int busIndex) {
+	armGenericDashRingReceive(&loop->ring, loop->buses[busIndex].socketFd, (uint64_t)busIndex);
+}
+
+static void cancelGenericDashRingReceive(GenericDashEventLoopRing* ring, uint64_t userData) {
+	unsigned int tail = *ring->submissionTail;
+	unsigned int index = tail & ring->submissionMask;
+	struct io_uring_sqe* entry = &((struct io_uring_sqe*)ring->submissionEntries)[index];
+
+	memset(entry, 0, sizeof(*entry));
+	entry->opcode = IORING_OP_ASYNC_CANCEL;
+	entry->fd = -1;
+	entry->addr = userData;
+	entry->user_data = GenericDashRingCancel;
+
+	ring->submissionArray[index] = index;
+	__atomic_store_n(ring->submissionTail, tail + 1, __ATOMIC_RELEASE);
+	ring->pendingSubmissions++;
+}
+
+/*
+ The kernel headers only say what the library was built against, and a kernel
+ older than 6.0 rejects a multishot receive with -EINVAL even though it knows
+ the opcode. So arm one on a socket pair, send it a datagram and check it
+ completes still armed, then cancel it again.
+ */
+static bool probeGenericDashEventLoopRing(GenericDashEventLoopRing* ring) {
+	int pair[2];
+	if (socketpair(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0, pair) < 0) return false;
+
+	armGenericDashRingReceive(ring, pair[0], GenericDashRingProbe);
+	bool received = false, cancelled = false;
+	int outstanding = 1; // Submissions whose last completion hasn't arrived
+	if (send(pair[1], "", 1, 0) != 1) outstanding = -1;
+
+	for (int attempt = 0; outstanding > 0 && attempt < 4; attempt++) {
+		if (enterGenericDashEventLoopRing(ring, 1, 100) < 0) break;
+
+		struct io_uring_cqe* completions = (struct io_uring_cqe*)ring->completionEntries;
+		unsigned int head = *ring->completionHead;
+		unsigned int tail = __atomic_load_n(ring->completionTail, __ATOMIC_ACQUIRE);
+		for (; head != tail; head++) {
+			struct io_uring_cqe* completion = &completions[head & ring->completionMask];
+			if (completion->flags & IORING_CQE_F_BUFFER) recycleGenericDashRingBuffer(ring, (unsigned short)(completion->flags >> IORING_CQE_BUFFER_SHIFT));
+			if (completion->user_data == GenericDashRingProbe && completion->res > 0 && (completion->flags & IORING_CQE_F_MORE)) received = true;
+			if (!(completion->flags & IORING_CQE_F_MORE)) outstanding--;
+		}
+		__atomic_store_n(ring->completionHead, head, __ATOMIC_RELEASE);
+		publishGenericDashRingBuffers(ring);
+
+		if (received && !cancelled && outstanding > 0) {
+			cancelGenericDashRingReceive(ring, GenericDashRingProbe);
+			cancelled = true;
+			outstanding++;
+		}
+	}
+
+	close(pair[0]);
+	close(pair[1]);
+	return received && outstanding == 0;
+}
+
+static void unmapGenericDashEventLoopRing(GenericDashEventLoopRing* ring) {
+	if (ring->ringFd >= 0) close(ring->ringFd);
+	if (ring->bufferRing != NULL) munmap(ring->bufferRing, ring->bufferRingSize);
+	if (ring->submissionEntries != NULL) munmap(ring->submissionEntries, ring->submissionEntriesSize);
+	if (ring->completionRing != NULL && ring->completionRing != ring->submissionRing) munmap(ring->completionRing, ring->completionRingSize);
+	if (ring->submissionRing != NULL) munmap(ring->submissionRing, ring->submissionRingSize);
+	memset(ring, 0, sizeof(*ring));
+	ring->ringFd = -1;
+}
+
+static bool setupGenericDashEventLoopRing(GenericDashEventLoopRing* ring) {
+	struct io_uring_params params;
+	memset(&params, 0, sizeof(params));
+	ring->ringFd = (int)syscall(__NR_io_uring_setup, GenericDashRingEntries, &params);
+	if (ring->ringFd < 0) return false;
+	if (!(params.features & IORING_FEAT_EXT_ARG)) goto failed;
+
+	ring->submissionRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+	ring->completionRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		if (ring->completionRingSize > ring->submissionRingSize) ring->submissionRingSize = ring->completionRingSize;
+		ring->completionRingSize = ring->submissionRingSize;
+	}
+
+	ring->submissionRing = mmap(NULL, ring->submissionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ringFd, IORING_OFF_SQ_RING);
+	if (ring->submissionRing == MAP_FAILED) {
+		ring->submissionRing = NULL;
+		goto failed;
+	}
+	if (params.features & IORING_FEAT_SINGLE_MMAP) {
+		ring->completionRing = ring->submissionRing;
+	} else {
+		ring->completionRing = mmap(NULL, ring->completionRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ringFd, IORING_OFF_CQ_RING);
+		if (ring->completionRing == MAP_FAILED) {
+			ring->completionRing = NULL;
+			goto failed;
+		}
+	}
+	ring->submissionEntriesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+	ring->submissionEntries = mmap(NULL, ring->submissionEntriesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, ring->ringFd, IORING_OFF_SQES);
+	if (ring->submissionEntries == MAP_FAILED) {
+		ring->submissionEntries = NULL;
+		goto failed;
+	}
+
+	unsigned char* submission = (unsigned char*)ring->submissionRing;
+	unsigned char* completion = (unsigned char*)ring->completionRing;
+	ring->submissionTail = (unsigned int*)(submission + params.sq_off.tail);
+	ring->submissionArray = (unsigned int*)(submission + params.sq_off.array);
+	ring->submissionMask = *(unsigned int*)(submission + params.sq_off.ring_mask);
+	ring->completionHead = (unsigned int*)(completion + params.cq_off.head);
+	ring->completionTail = (unsigned int*)(completion + params.cq_off.tail);
+	ring->completionMask = *(unsigned int*)(completion + params.cq_off.ring_mask);
+	ring->completionEntries = completion + params.cq_off.cqes;
+
+	// Buffer descriptors come first as the kernel needs them page aligned, the buffers themselves follow
+	ring->bufferRingSize = GenericDashRingBuffers * (sizeof(struct io_uring_buf) + GenericDashRingBufferSize);
+	ring->bufferRing = mmap(NULL, ring->bufferRingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (ring->bufferRing == MAP_FAILED) {
+		ring->bufferRing = NULL;
+		goto failed;
+	}
+	ring->bufferMemory = (unsigned char*)ring->bufferRing + GenericDashRingBuffers * sizeof(struct io_uring_buf);
+
+	struct io_uring_buf_reg registration;
+	memset(&registration, 0, sizeof(registration));
+	registration.ring_addr = (uint64_t)(uintptr_t)ring->bufferRing;
+	registration.ring_entries = GenericDashRingBuffers;
+	registration.bgid = GenericDashRingBufferGroup;
+	if (syscall(__NR_io_uring_register, ring->ringFd, IORING_REGISTER_PBUF_RING, &registration, 1) < 0) goto failed;
+
+	for (unsigned short i = 0; i < GenericDashRingBuffers; i++) recycleGenericDashRingBuffer(ring, i);
+	publishGenericDashRingBuffers(ring);
+	if (!probeGenericDashEventLoopRing(ring)) goto failed;
+	return true;
+
+failed:
+	unmapGenericDashEventLoopRing(ring);
+	return false;
+}
+
+static int deliverGenericDashRingMessage(GenericDashBus* bus, unsigned char* buffer, int length) {
+	const size_t headerLength = sizeof(struct io_uring_recvmsg_out) + GenericDashRingMessage.msg_namelen + GenericDashRingMessage.msg_controllen;
+	struct io_uring_recvmsg_out* received = (struct io_uring_recvmsg_out*)buffer;
+	if ((size_t)length < headerLength || (received->flags & MSG_TRUNC)) return 0;
+
+	struct msghdr control;
+	memset(&control, 0, sizeof(control));
+	control.msg_control = buffer + sizeof(struct io_uring_recvmsg_out) + GenericDashRingMessage.msg_namelen;
+	control.msg_controllen = received->controllen;
+
+	return deliverGenericDashBusFrame(bus, (const struct can_frame*)(buffer + headerLength), length - headerLength, linkGenericDashReceiveTimestamp(&control));
+}
+
+static int runGenericDashEventLoopRing(GenericDashEventLoop* loop, int timeoutMs) {
+	GenericDashEventLoopRing* ring = &loop->ring;
+	unsigned int head = *ring->completionHead;
+
+	// Only enter the kernel if there's something to submit or nothing has completed yet
+	if (ring->pendingSubmissions || head == __atomic_load_n(ring->completionTail, __ATOMIC_ACQUIRE)) {
+		if (enterGenericDashEventLoopRing(ring, timeoutMs == 0 ? 0 : 1, timeoutMs) < 0) return -1;
+	}
+
+	struct io_uring_cqe* completions = (struct io_uring_cqe*)ring->completionEntries;
+	unsigned int tail = __atomic_load_n(ring->completionTail, __ATOMIC_ACQUIRE);
+	bool recycled = false, failed = false;
+	int delivered = 0;
+
+	for (; head != tail; head++) {
+		struct io_uring_cqe* completion = &completions[head & ring->completionMask];
+		int busIndex = (int)completion->user_data;
+
+		if (completion->flags & IORING_CQE_F_BUFFER) {
+			unsigned short id = (unsigned short)(completion->flags >> IORING_CQE_BUFFER_SHIFT);
+			if (completion->res > 0)
+				delivered += deliverGenericDashRingMessage(&loop->buses[busIndex], ring->bufferMemory + id * GenericDashRingBufferSize, completion->res);
+			recycleGenericDashRingBuffer(ring, id);
+			recycled = true;
+		}
+
+		// Multishot stops when buffers run out or on error - re-arm unless the socket itself has failed
+		if (!(completion->flags & IORING_CQE_F_MORE)) {
+			if (completion->res >= 0 || completion->res == -ENOBUFS || completion->res == -EINTR) armGenericDashRingBus(loop, busIndex);
+			else failed = true;
+		}
+	}
+	__atomic_store_n(ring->completionHead, head, __ATOMIC_RELEASE);
+	if (recycled) publishGenericDashRingBuffers(ring);
+	if (ring->pendingSubmissions && enterGenericDashEventLoopRing(ring, 0, 0) < 0) return -1;
+
+	return failed ? -1 : delivered;
+}
+
+#endif // GENERIC_DASH_IO_URING
+
+bool initGenericDashEventLoop(GenericDashEventLoop* loop, GenericDashEventLoopBackends backend) {
+	memset(loop, 0, sizeof(*loop));
+	loop->epollFd = -1;
+	loop->ring.ringFd = -1;
+
+#ifdef GENERIC_DASH_IO_URING
+	if (backend == EVENT_LOOP_BACKEND_IO_URING && setupGenericDashEventLoopRing(&loop->ring)) {
+		loop->backend = EVENT_LOOP_BACKEND_IO_URING;
+		return true;
+	}
+#else
+	(void)backend;
+#endif
+
+	loop->backend = EVENT_LOOP_BACKEND_EPOLL;
+	loop->epollFd = epoll_create1(EPOLL_CLOEXEC);
+	return loop->epollFd >= 0;
+}
+
+GenericDashBus* addGenericDashEventLoopSocket(GenericDashEventLoop* loop, int socketFd, unsigned int canId, GenericDashContext* context, GenericDashBusCallback callback, void* user) {
+	if (loop->busCount >= maxGenericDashEventLoopBuses || socketFd < 0 || context == NULL) return NULL;
+
+	int busIndex = loop->busCount;
+	GenericDashBus* bus = &loop->buses[busIndex];
+	bus->socketFd = socketFd;
+	bus->ownsSocket = false;
+	bus->canId = canId;
+	bus->context = context;
+	bus->callback = callback;
+	bus->user = user;
+	bus->counters = NULL;
+
+	int enabled = 1;
+	setsockopt(socketFd, SOL_SOCKET, SO_TIMESTAMPNS, &enabled, sizeof(enabled));
+
+#ifdef GENERIC_DASH_IO_URING
+	if (loop->backend == EVENT_LOOP_BACKEND_IO_URING) {
+		armGenericDashRingBus(loop, busIndex);
+		loop->busCount++;
+		return bus;
+	}
+#endif
+
+	struct epoll_event event;
+	memset(&event, 0, sizeof(event));
+	event.events = EPOLLIN;
+	event.data.u32 = (uint32_t)busIndex;
+	if (epoll_ctl(loop->epollFd, EPOLL_CTL_ADD, socketFd, &event) < 0) return NULL;
+	loop->busCount++;
+	return bus;
+}
+
+GenericDashBus* addGenericDashEventLoopBus(GenericDashEventLoop* loop, const char* interface, unsigned int canId, GenericDashContext* context, GenericDashBusCallback callback, void* user) {
+	int socketFd = socket(PF_CAN, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, CAN_RAW);
+	if (socketFd < 0) return NULL;
+
+	// Let the kernel drop everything that isn't Generic Dash so we're never woken for it
+	bool extended = canId > CAN_SFF_MASK;
+	struct can_filter filter;
+	filter.can_id = extended ? (canId | CAN_EFF_FLAG) : canId;
+	filter.can_mask = CAN_EFF_FLAG | CAN_RTR_FLAG | (extended ? CAN_EFF_MASK : CAN_SFF_MASK);
+
+	struct sockaddr_can address;
+	memset(&address, 0, sizeof(address));
+	address.can_family = AF_CAN;
+	address.can_ifindex = if_nametoindex(interface);
+
+	if (address.can_ifindex == 0
+		|| setsockopt(socketFd, SOL_CAN_RAW, CAN_RAW_FILTER, &filter, sizeof(filter)) < 0
+		|| bind(socketFd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+		close(socketFd);
+		return NULL;
+	}
+
+	GenericDashBus* bus = addGenericDashEventLoopSocket(loop, socketFd, canId, context, callback, user);
+	if (bus == NULL) {
+		close(socketFd);
+		return NULL;
+	}
+	bus->ownsSocket = true;
+	return bus;
+}
+
+int runGenericDashEventLoop(GenericDashEventLoop* loop, int timeoutMs) {
+#ifdef GENERIC_DASH_IO_URING
+	if (loop->backend == EVENT_LOOP_BACKEND_IO_URING) return runGenericDashEventLoopRing(loop, timeoutMs);
+#endif
+	return runGenericDashEventLoopEpoll(loop, timeoutMs);
+}
+
+void closeGenericDashEventLoop(GenericDashEventLoop* loop) {
+#ifdef GENERIC_DASH_IO_URING
+	// Closing the ring first cancels any receives still armed on the sockets
+	if (loop->backend == EVENT_LOOP_BACKEND_IO_URING) unmapGenericDashEventLoopRing(&loop->ring);
+#endif
+	if (loop->epollFd >= 0) close(loop->epollFd);
+	for (int i = 0; i < loop->busCount; i++)
+		if (loop->buses[i].ownsSocket) close(loop->buses[i].socketFd);
+	loop->epollFd = -1;
+	loop->busCount = 0;
+}
+
+#endif // __linux__
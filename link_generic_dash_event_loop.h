@@ -0,0 +1,171 @@
+/*
+ link_generic_dash_event_loop.h - Single threaded reader for several SocketCAN buses
+ For copyright and license information see LICENSE
+
+ Serves any number of Generic Dash streams from one thread, ie. a gateway
+ with two ECUs on different CAN interfaces. Each bus is its own SocketCAN
+ socket, filtered in the kernel to the Generic Dash CAN ID, and is bound to
+ its own GenericDashContext. Frames are parsed into the right context as they
+ arrive and passed to an optional callback along with the kernel's receive
+ timestamp.
+
+ Two backends are available:
+ - epoll, which reads up to 32 frames per system call with recvmmsg
+ - io_uring, which keeps a multishot receive armed on every bus so frames
+   are delivered without any per-frame system calls at all
+
+ The io_uring backend needs Linux 6.0 or later, both to build and to run.
+ The running kernel is checked when the loop is set up, by arming a multishot
+ receive on a socket pair, and asking for io_uring on an older kernel falls
+ back to epoll. Only available on Linux. Some optional defines you can add
+ before including this file:
+
+ #define NO_DASH_IO_URING
+ Will not include the io_uring backend, ie. for older kernel headers.
+ */
+
+#ifndef link_generic_dash_event_loop_h
+#define link_generic_dash_event_loop_h
+
+#include "link_generic_dash.h"
+#include "link_generic_dash_counters.h"
+
+#ifdef __linux__
+
+#include <linux/version.h>
+
+#if !defined(NO_DASH_IO_URING) && LINUX_VERSION_CODE >= KERNEL_VERSION(6, 0, 0)
+#define GENERIC_DASH_IO_URING
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Maximum number of buses a single event loop can serve
+ */
+#define maxGenericDashEventLoopBuses 16
+
+/**
+ * @brief Ways an event loop can wait for frames
+ */
+typedef enum {
+	EVENT_LOOP_BACKEND_EPOLL,
+	EVENT_LOOP_BACKEND_IO_URING,
+} GenericDashEventLoopBackends;
+
+typedef struct GenericDashBus GenericDashBus;
+
+/**
+ * @brief Called for every Generic Dash frame received on a bus, after it has been parsed
+ * @param bus is the bus the frame arrived on, its context is already up to date
+ * @param record is the frame and its kernel receive timestamp in microseconds
+ * @param accepted is the result of parsing the frame
+ */
+typedef void (*GenericDashBusCallback)(GenericDashBus* bus, const GenericDashRecord* record, bool accepted);
+
+/**
+ * @brief A single CAN bus being served by an event loop
+ */
+struct GenericDashBus {
+	int socketFd;
+	bool ownsSocket;
+	unsigned int canId;
+	GenericDashContext* context;
+	GenericDashBusCallback callback;
+	void* user; // Anything you like, ie. which ECU this is
+	GenericDashCounters* counters; // Set this to count frames received on this bus, NULL by default
+};
+
+/**
+ * @brief Shared memory of an io_uring instance, only used by the io_uring backend
+ */
+typedef struct {
+	int ringFd;
+	unsigned int pendingSubmissions;
+	unsigned int* submissionTail;
+	unsigned int* submissionArray;
+	unsigned int submissionMask;
+	void* submissionEntries;
+	unsigned int* completionHead;
+	unsigned int* completionTail;
+	unsigned int completionMask;
+	void* completionEntries;
+	void* bufferRing;
+	unsigned char* bufferMemory;
+	unsigned short bufferTail;
+
+	// Mappings to undo when closing
+	void* submissionRing;
+	size_t submissionRingSize;
+	void* completionRing;
+	size_t completionRingSize;
+	size_t submissionEntriesSize;
+	size_t bufferRingSize;
+} GenericDashEventLoopRing;
+
+/**
+ * @brief Serves a set of buses from a single thread
+ */
+typedef struct {
+	GenericDashEventLoopBackends backend;
+	int epollFd;
+	GenericDashBus buses[maxGenericDashEventLoopBuses];
+	int busCount;
+	GenericDashEventLoopRing ring;
+} GenericDashEventLoop;
+
+/**
+ * @brief Sets up an event loop with no buses
+ * @param loop is the event loop to set up
+ * @param backend is the backend to use, EVENT_LOOP_BACKEND_IO_URING falls back to epoll if unavailable
+ * @return true if successful, false otherwise - loop->backend says which backend is in use
+ */
+bool initGenericDashEventLoop(GenericDashEventLoop* loop, GenericDashEventLoopBackends backend);
+
+/**
+ * @brief Opens a CAN interface and adds it to an event loop
+ * @param loop is the event loop to add to
+ * @param interface is the interface name ie. "can0"
+ * @param canId is the Generic Dash CAN ID on this bus, normally defaultGenericDashCanId
+ * @param context is the decoder context frames from this bus are parsed into
+ * @param callback is called for every frame received, or NULL
+ * @param user is stored in the bus for use by the callback
+ * @return GenericDashBus* the new bus or NULL on failure
+ */
+GenericDashBus* addGenericDashEventLoopBus(GenericDashEventLoop* loop, const char* interface, unsigned int canId, GenericDashContext* context, GenericDashBusCallback callback, void* user);
+
+/**
+ * @brief Adds a socket you've opened yourself to an event loop, receive timestamps are turned on but it is not closed by the loop
+ * @param loop is the event loop to add to
+ * @param socketFd is a datagram socket that receives struct can_frame
+ * @param canId is the Generic Dash CAN ID on this bus, other CAN IDs are ignored
+ * @param context is the decoder context frames from this bus are parsed into
+ * @param callback is called for every frame received, or NULL
+ * @param user is stored in the bus for use by the callback
+ * @return GenericDashBus* the new bus or NULL on failure
+ */
+GenericDashBus* addGenericDashEventLoopSocket(GenericDashEventLoop* loop, int socketFd, unsigned int canId, GenericDashContext* context, GenericDashBusCallback callback, void* user);
+
+/**
+ * @brief Waits for frames on any bus and delivers everything that has arrived
+ * @param loop is the event loop to run
+ * @param timeoutMs is how long to wait for frames, 0 to not wait or -1 to wait forever
+ * @return int number of frames delivered or -1 on failure
+ */
+int runGenericDashEventLoop(GenericDashEventLoop* loop, int timeoutMs);
+
+/**
+ * @brief Closes an event loop and every socket it opened
+ * @param loop is the event loop to close
+ */
+void closeGenericDashEventLoop(GenericDashEventLoop* loop);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __linux__
+
+#endif // link_generic_dash_event_loop_h
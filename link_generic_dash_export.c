@@ -0,0 +1,228 @@
+/*
+ Any additions to this file will need suitable additions to link_generic_dash_export.h
+ For documentation please the above file.
+ */
+
+#include "link_generic_dash_export.h"
+
+#include <math.h>
+#include <stddef.h>
+
+#ifndef NO_DASH_VALUE_STRINGS
+
+static const char GenericDashExportTimeLabel[] = "Time (s)";
+static const char GenericDashExportJsonTimeLabel[] = "{\"Time (s)\":";
+#define GenericDashExportTimeDecimalPlaces 6
+
+static const double GenericDashExportScales[] = { 1, 10, 100, 1000, 10000, 100000, 1000000 };
+#define maxGenericDashExportDecimalPlaces 6
+
+#define allGenericDashExportFrames ((1 << Generic_Dash_Frame_Count) - 1)
+
+/*
+ Writes a label quoted for the format, ie. "Engine Speed (RPM)": for JSON or
+ Engine Speed (RPM) for CSV, which only needs quotes if it has a comma or quote in it
+ */
+static unsigned char buildGenericDashExportLabel(GenericDashExportFormats format, const char* text, char label[maxGenericDashExportLabelLength]) {
+	bool quoted = format == EXPORT_FORMAT_JSON_LINES || strpbrk(text, ",\"") != NULL;
+	int length = 0;
+	int limit = maxGenericDashExportLabelLength - 3; // Room for the closing quote, colon and terminator
+
+	if (quoted) label[length++] = '"';
+	for (const char* p = text; *p && length < limit - 1; p++) {
+		if (*p == '"') label[length++] = format == EXPORT_FORMAT_JSON_LINES ? '\\' : '"';
+		else if (*p == '\\' && format == EXPORT_FORMAT_JSON_LINES) label[length++] = '\\';
+		label[length++] = *p;
+	}
+	if (quoted) label[length++] = '"';
+	if (format == EXPORT_FORMAT_JSON_LINES) label[length++] = ':';
+	label[length] = 0;
+	return (unsigned char)length;
+}
+
+/*
+ Writes value / 10^decimalPlaces with exactly that many decimal places
+ */
+static char* writeGenericDashExportFixed(char* out, int64_t value, unsigned char decimalPlaces) {
+	char digits[24];
+	int count = 0;
+	uint64_t magnitude = value < 0 ? (uint64_t)0 - (uint64_t)value : (uint64_t)value;
+	do {
+		digits[count++] = (char)('0' + magnitude % 10);
+		magnitude /= 10;
+	} while (magnitude != 0 || count <= decimalPlaces);
+
+	if (value < 0) *out++ = '-';
+	for (int i = count - 1; i >= 0; i--) {
+		if (i == decimalPlaces - 1) *out++ = '.';
+		*out++ = digits[i];
+	}
+	return out;
+}
+
+static void formatGenericDashExportValue(GenericDashExporter* exporter, int param) {
+	char* text = exporter->values[param];
+	char* end = text;
+	if (!(exporter->seenFrames & (1 << (param / 3)))) {
+		if (exporter->format == EXPORT_FORMAT_JSON_LINES) {
+			memcpy(text, "null", 4);
+			end += 4;
+		}
+	} else {
+		/*
+		 A float times a power of ten up to a million is exact as a double, so
+		 rounding it half to even prints the same digits as printf("%.*f") would
+		 */
+		unsigned char decimalPlaces = exporter->decimalPlaces[param];
+		double scaled = (double)decodeGenericDashValue((GenericDashParameters)param, exporter->context.words[param]) * GenericDashExportScales[decimalPlaces];
+		end = writeGenericDashExportFixed(text, (int64_t)llrint(scaled), decimalPlaces);
+	}
+	exporter->valueLengths[param] = (unsigned char)(end - text);
+}
+
+static bool passGenericDashExportBuffer(GenericDashExporter* exporter) {
+	if (exporter->failed) return false;
+	if (exporter->used == 0) return true;
+	if (exporter->sink != NULL && !exporter->sink(exporter, exporter->buffer, exporter->used)) exporter->failed = true;
+	exporter->used = 0;
+	return !exporter->failed;
+}
+
+static void writeGenericDashExportHeader(GenericDashExporter* exporter) {
+	char* out = exporter->buffer + exporter->used;
+	memcpy(out, GenericDashExportTimeLabel, sizeof(GenericDashExportTimeLabel) - 1);
+	out += sizeof(GenericDashExportTimeLabel) - 1;
+	for (int i = 0; i < exporter->columnCount; i++) {
+		int param = exporter->columns[i];
+		*out++ = ',';
+		memcpy(out, exporter->labels[param], exporter->labelLengths[param]);
+		out += exporter->labelLengths[param];
+	}
+	*out++ = '\n';
+	exporter->used = (size_t)(out - exporter->buffer);
+}
+
+static bool writeGenericDashExportRow(GenericDashExporter* exporter, uint64_t timestamp) {
+	if (exporter->used > sizeof(exporter->buffer) - maxGenericDashExportRowLength && !passGenericDashExportBuffer(exporter)) return false;
+	if (!exporter->headerWritten) {
+		if (exporter->format == EXPORT_FORMAT_CSV) writeGenericDashExportHeader(exporter);
+		exporter->headerWritten = true;
+	}
+
+	char* out = exporter->buffer + exporter->used;
+	bool json = exporter->format == EXPORT_FORMAT_JSON_LINES;
+	if (json) {
+		memcpy(out, GenericDashExportJsonTimeLabel, sizeof(GenericDashExportJsonTimeLabel) - 1);
+		out += sizeof(GenericDashExportJsonTimeLabel) - 1;
+	}
+	out = writeGenericDashExportFixed(out, (int64_t)timestamp, GenericDashExportTimeDecimalPlaces);
+
+	// Labels and values are copied whole, the row limit leaves room to copy past their ends
+	for (int i = 0; i < exporter->columnCount; i++) {
+		int param = exporter->columns[i];
+		if (exporter->stale & ((uint64_t)1 << param)) formatGenericDashExportValue(exporter, param);
+		*out++ = ',';
+		if (json) {
+			memcpy(out, exporter->labels[param], maxGenericDashExportLabelLength);
+			out += exporter->labelLengths[param];
+		}
+		memcpy(out, exporter->values[param], maxGenericDashExportValueLength);
+		out += exporter->valueLengths[param];
+	}
+	exporter->stale = 0;
+	if (json) *out++ = '}';
+	*out++ = '\n';
+
+	exporter->used = (size_t)(out - exporter->buffer);
+	exporter->rows++;
+	return true;
+}
+
+void initGenericDashExporter(GenericDashExporter* exporter, GenericDashExportFormats format, GenericDashExportSink sink, void* user) {
+	memset(exporter, 0, offsetof(GenericDashExporter, buffer));
+	exporter->format = format;
+	exporter->sink = sink;
+	exporter->user = user;
+	initGenericDashContext(&exporter->context);
+
+	GenericDashParameters params[Generic_Dash_Parameter_Count];
+	for (int i = 0; i < Generic_Dash_Parameter_Count; i++) params[i] = (GenericDashParameters)i;
+	setGenericDashExporterColumns(exporter, params, Generic_Dash_Parameter_Count);
+}
+
+bool setGenericDashExporterColumns(GenericDashExporter* exporter, const GenericDashParameters* params, size_t count) {
+	if (count > Generic_Dash_Parameter_Count) return false;
+	for (size_t i = 0; i < count; i++)
+		if ((int)params[i] < 0 || (int)params[i] >= Generic_Dash_Parameter_Count) return false;
+
+	exporter->selected = 0;
+	exporter->stale = ~(uint64_t)0;
+	exporter->columnCount = (unsigned char)count;
+	for (size_t i = 0; i < count; i++) {
+		int param = params[i];
+		exporter->columns[i] = (unsigned char)param;
+		if (exporter->selected & ((uint64_t)1 << param)) continue;
+		exporter->selected |= (uint64_t)1 << param;
+
+		// Labels and decimal places are looked up once here rather than for every value
+		char name[maxGenericDashParameterNameLength] = { 0 };
+		char uom[maxGenericDashParameterUomLength] = { 0 };
+		char text[maxGenericDashParameterNameLength + maxGenericDashParameterUomLength + 4];
+		getGenericDashParameterName((GenericDashParameters)param, name);
+		getGenericDashParameterUom((GenericDashParameters)param, uom);
+		if (strspn(uom, " ") != strlen(uom)) snprintf(text, sizeof(text), "%s (%s)", name, uom);
+		else snprintf(text, sizeof(text), "%s", name);
+		exporter->labelLengths[param] = buildGenericDashExportLabel(exporter->format, text, exporter->labels[param]);
+
+		signed int decimalPlaces = getGenericDashParameterDecimalPlaces((GenericDashParameters)param);
+		exporter->decimalPlaces[param] = (unsigned char)(decimalPlaces < 0 ? 0 : decimalPlaces > maxGenericDashExportDecimalPlaces ? maxGenericDashExportDecimalPlaces : decimalPlaces);
+	}
+	return true;
+}
+
+bool exportGenericDashRecords(GenericDashExporter* exporter, const GenericDashRecord* records, size_t count) {
+	if (exporter->failed) return false;
+	for (size_t i = 0; i < count; i++) {
+		const unsigned char* frame = records[i].frame;
+		if (frame[0] >= Generic_Dash_Frame_Count || frame[1] != 0) continue;
+
+		// Only the three parameters in this frame can have changed
+		int first = frame[0] * 3;
+		uint16_t previous[3];
+		memcpy(previous, &exporter->context.words[first], sizeof(previous));
+		parseGenericDashContextCanFrame(&exporter->context, frame);
+
+		uint16_t bit = (uint16_t)(1 << frame[0]);
+		uint64_t columns = (exporter->selected >> first) & 0x7;
+		uint64_t changed = exporter->seenFrames & bit ? 0 : columns;
+		exporter->seenFrames |= bit;
+		for (int j = 0; j < 3; j++)
+			if (previous[j] != exporter->context.words[first + j]) changed |= columns & (1 << j);
+		exporter->stale |= changed << first;
+		if (changed && !writeGenericDashExportRow(exporter, records[i].timestamp)) return false;
+	}
+	return true;
+}
+
+bool exportGenericDashContext(GenericDashExporter* exporter, uint64_t timestamp, const GenericDashContext* context) {
+	if (exporter->failed) return false;
+	uint64_t changed = exporter->seenFrames == allGenericDashExportFrames ? 0 : exporter->selected;
+	for (int i = 0; i < Generic_Dash_Parameter_Count; i++)
+		if (exporter->context.words[i] != context->words[i]) changed |= exporter->selected & ((uint64_t)1 << i);
+
+	exporter->context = *context;
+	exporter->seenFrames = allGenericDashExportFrames;
+	exporter->stale |= changed;
+	return !changed || writeGenericDashExportRow(exporter, timestamp);
+}
+
+bool flushGenericDashExporter(GenericDashExporter* exporter) {
+	// A CSV export with no rows still gets its header
+	if (!exporter->failed && !exporter->headerWritten) {
+		if (exporter->format == EXPORT_FORMAT_CSV) writeGenericDashExportHeader(exporter);
+		exporter->headerWritten = true;
+	}
+	return passGenericDashExportBuffer(exporter);
+}
+
+#endif // NO_DASH_VALUE_STRINGS
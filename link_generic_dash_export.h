@@ -0,0 +1,151 @@
+/*
+ link_generic_dash_export.h - Streaming CSV and JSON lines exporter
+ For copyright and license information see LICENSE
+
+ Writes decoded Generic Dash values out as CSV or JSON lines, one row per
+ change, for handing sessions to spreadsheets and web tools. Pick the
+ parameters to export and their order, and each column is labelled from the
+ parameter's name and unit, ie. "Engine Speed (RPM)". Values are printed at the
+ parameter's decimal places with integer formatting rather than printf, so
+ every export of the same data comes out byte for byte the same.
+
+ Text is gathered in a buffer inside the exporter and handed to a sink
+ callback a buffer at a time, so it can go to a file, a socket or anywhere
+ else. Fed recorded frames, a row is only written when a frame changes one of
+ the exported values, and parameters whose frame hasn't been seen yet are
+ left empty in CSV or null in JSON.
+
+ The exporter needs the parameter name strings, so isn't available with
+ NO_DASH_VALUE_STRINGS defined.
+ */
+
+#ifndef link_generic_dash_export_h
+#define link_generic_dash_export_h
+
+#include "link_generic_dash.h"
+
+#ifndef NO_DASH_VALUE_STRINGS
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Size of the buffer text is gathered in before being passed to the sink
+ */
+#define defaultGenericDashExportBufferSize (16 * 1024)
+
+/**
+ * @brief Longest a single row can be, in either format with every parameter exported
+ */
+#define maxGenericDashExportRowLength 4096
+
+/**
+ * @brief Longest column label, including quotes and the JSON separator
+ */
+#define maxGenericDashExportLabelLength (maxGenericDashParameterNameLength + maxGenericDashParameterUomLength + 8)
+
+/**
+ * @brief Longest formatted value
+ */
+#define maxGenericDashExportValueLength 24
+
+/**
+ * @brief Formats that can be exported
+ */
+typedef enum {
+	EXPORT_FORMAT_CSV,        // Header line, then one comma separated line per row
+	EXPORT_FORMAT_JSON_LINES, // One JSON object per line, keyed by column label
+} GenericDashExportFormats;
+
+typedef struct GenericDashExporter GenericDashExporter;
+
+/**
+ * @brief Called with each buffer of exported text
+ * @param exporter is the exporter the text came from
+ * @param text is the text, not null terminated
+ * @param length is the length of text
+ * @return true if written, false to stop exporting
+ */
+typedef bool (*GenericDashExportSink)(GenericDashExporter* exporter, const char* text, size_t length);
+
+/**
+ * @brief Exporter settings, columns and output buffer
+ */
+struct GenericDashExporter {
+	GenericDashExportFormats format;
+	GenericDashExportSink sink;
+	void* user; // Anything you like, ie. the FILE* being written
+	GenericDashContext context; // Values as of the last row
+	uint16_t seenFrames; // Bit n set once frame n has been exported
+
+	// Columns, cached from the parameter metadata by setGenericDashExporterColumns
+	unsigned char columns[Generic_Dash_Parameter_Count];
+	unsigned char columnCount;
+	uint64_t selected; // Bit n set if parameter n is a column
+	unsigned char decimalPlaces[Generic_Dash_Parameter_Count];
+	char labels[Generic_Dash_Parameter_Count][maxGenericDashExportLabelLength]; // Ready to write, quoted as needed
+	unsigned char labelLengths[Generic_Dash_Parameter_Count];
+
+	// Each value is only formatted again when it changes
+	char values[Generic_Dash_Parameter_Count][maxGenericDashExportValueLength];
+	unsigned char valueLengths[Generic_Dash_Parameter_Count];
+	uint64_t stale; // Bit n set if parameter n has changed since it was last formatted
+
+	bool headerWritten;
+	bool failed; // The sink returned false, nothing more is written
+	uint64_t rows;
+	size_t used;
+	char buffer[defaultGenericDashExportBufferSize];
+};
+
+/**
+ * @brief Sets up an exporter with every parameter as a column
+ * @param exporter is the exporter to set up
+ * @param format is one of enum GenericDashExportFormats
+ * @param sink is called with each buffer of text
+ * @param user is stored in the exporter for use by the sink
+ */
+void initGenericDashExporter(GenericDashExporter* exporter, GenericDashExportFormats format, GenericDashExportSink sink, void* user);
+
+/**
+ * @brief Chooses which parameters are exported and in what order, before anything is exported
+ * @param exporter is the exporter to change
+ * @param params are the parameters to export, one per column
+ * @param count is the number of parameters, up to Generic_Dash_Parameter_Count
+ * @return true if set, false if a parameter is unknown, leaving the columns unchanged
+ */
+bool setGenericDashExporterColumns(GenericDashExporter* exporter, const GenericDashParameters* params, size_t count);
+
+/**
+ * @brief Exports recorded frames, writing a row whenever a frame changes an exported value
+ * @param exporter is the exporter to use
+ * @param records are the frames and their timestamps in microseconds
+ * @param count is the number of records
+ * @return true if exported, false if the sink has stopped the export
+ */
+bool exportGenericDashRecords(GenericDashExporter* exporter, const GenericDashRecord* records, size_t count);
+
+/**
+ * @brief Exports every value of a decoder context, writing a row if any exported value changed since the last
+ * @param exporter is the exporter to use
+ * @param timestamp is the row's timestamp in microseconds
+ * @param context is the decoder context to export
+ * @return true if exported, false if the sink has stopped the export
+ */
+bool exportGenericDashContext(GenericDashExporter* exporter, uint64_t timestamp, const GenericDashContext* context);
+
+/**
+ * @brief Passes anything left in the buffer to the sink, call once the export is finished
+ * @param exporter is the exporter to flush
+ * @return true if flushed, false if the sink has stopped the export
+ */
+bool flushGenericDashExporter(GenericDashExporter* exporter);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // NO_DASH_VALUE_STRINGS
+
+#endif // link_generic_dash_export_h
@@ -0,0 +1,175 @@
+/*
+ Any additions to this file will need suitable additions to link_generic_dash_fleet.h
+ For documentation please the above file.
+ */
+
+#include "link_generic_dash_fleet.h"
+
+#ifdef GENERIC_DASH_FLEET_DECODER
+
+#include <pthread.h>
+#include <stdatomic.h>
+#include <unistd.h>
+
+typedef struct {
+	GenericDashFleetStream* stream;
+	size_t first;
+	size_t last;
+	size_t acceptedFrames;
+	GenericDashContext seed; // State a decoder running from the start of the stream is in at first
+} GenericDashFleetChunk;
+
+/*
+ Each worker owns a contiguous range of chunks packed as (next << 32 | end).
+ The owner takes from the front and thieves take from the back, both with a
+ compare-and-swap on the whole range so the last chunk can't be taken twice.
+ */
+typedef struct {
+	_Atomic uint64_t range;
+	char padding[64 - sizeof(uint64_t)]; // Keep each worker's range on its own cache line
+} GenericDashFleetQueue;
+
+typedef struct {
+	GenericDashFleetChunk* chunks;
+	GenericDashFleetQueue* queues;
+	unsigned int workerCount;
+} GenericDashFleetPool;
+
+typedef struct {
+	GenericDashFleetPool* pool;
+	unsigned int worker;
+} GenericDashFleetWorker;
+
+static bool takeGenericDashFleetChunk(GenericDashFleetQueue* queue, bool fromBack, size_t* chunk) {
+	uint64_t range = atomic_load_explicit(&queue->range, memory_order_relaxed);
+	for (;;) {
+		uint32_t next = (uint32_t)(range >> 32);
+		uint32_t end = (uint32_t)range;
+		if (next >= end) return false;
+		uint64_t taken = fromBack ? ((uint64_t)next << 32) | (end - 1) : ((uint64_t)(next + 1) << 32) | end;
+		if (atomic_compare_exchange_weak_explicit(&queue->range, &range, taken, memory_order_acq_rel, memory_order_relaxed)) {
+			*chunk = fromBack ? end - 1 : next;
+			return true;
+		}
+	}
+}
+
+static void decodeGenericDashFleetChunk(GenericDashFleetChunk* chunk) {
+	GenericDashFleetStream* stream = chunk->stream;
+	const GenericDashRecord* records = stream->records;
+	GenericDashContext context = chunk->seed;
+	uint16_t* rawColumns[Generic_Dash_Parameter_Count];
+	float* columns[Generic_Dash_Parameter_Count];
+
+	for (int i = 0; i < Generic_Dash_Parameter_Count; i++) {
+		rawColumns[i] = stream->rawColumns[i] != NULL ? &stream->rawColumns[i][chunk->first] : NULL;
+		columns[i] = stream->columns[i] != NULL ? &stream->columns[i][chunk->first] : NULL;
+	}
+	chunk->acceptedFrames = decodeGenericDashBatch(&context, &records[chunk->first], chunk->last - chunk->first, rawColumns, columns);
+}
+
+static void* runGenericDashFleetWorker(void* argument) {
+	GenericDashFleetWorker* worker = (GenericDashFleetWorker*)argument;
+	GenericDashFleetPool* pool = worker->pool;
+	size_t chunk;
+
+	while (takeGenericDashFleetChunk(&pool->queues[worker->worker], false, &chunk))
+		decodeGenericDashFleetChunk(&pool->chunks[chunk]);
+
+	// Out of work, steal from whoever is next until everyone is out
+	for (unsigned int offset = 1; offset < pool->workerCount; offset++) {
+		GenericDashFleetQueue* victim = &pool->queues[(worker->worker + offset) % pool->workerCount];
+		while (takeGenericDashFleetChunk(victim, true, &chunk)) {
+			decodeGenericDashFleetChunk(&pool->chunks[chunk]);
+			offset = 0; // Something was stolen, so go around everyone again afterwards
+		}
+	}
+	return NULL;
+}
+
+bool decodeGenericDashFleet(GenericDashFleetStream* streams, size_t streamCount, unsigned int threadCount, size_t chunkRecords) {
+	if (chunkRecords == 0) chunkRecords = defaultGenericDashFleetChunkRecords;
+	if (threadCount == 0) {
+		long online = sysconf(_SC_NPROCESSORS_ONLN);
+		threadCount = online > 0 ? (unsigned int)online : 1;
+	}
+
+	size_t chunkCount = 0;
+	for (size_t i = 0; i < streamCount; i++) {
+		if (streams[i].records == NULL && streams[i].recordCount != 0) return false;
+		chunkCount += (streams[i].recordCount + chunkRecords - 1) / chunkRecords;
+	}
+	if (chunkCount > UINT32_MAX) return false;
+	if (threadCount > chunkCount) threadCount = chunkCount ? (unsigned int)chunkCount : 1;
+
+	GenericDashFleetChunk* chunks = calloc(chunkCount ? chunkCount : 1, sizeof(GenericDashFleetChunk));
+	GenericDashFleetQueue* queues = calloc(threadCount, sizeof(GenericDashFleetQueue));
+	GenericDashFleetWorker* workers = calloc(threadCount, sizeof(GenericDashFleetWorker));
+	pthread_t* threads = calloc(threadCount, sizeof(pthread_t));
+	if (chunks == NULL || queues == NULL || workers == NULL || threads == NULL) {
+		free(chunks);
+		free(queues);
+		free(workers);
+		free(threads);
+		return false;
+	}
+
+	/*
+	 Seed every chunk with the state decoding the stream in order would have
+	 reached by its first record. That's the previous chunk's seed updated with
+	 the latest copy of each frame in the previous chunk (its keyframe), found
+	 by scanning back from its end. The scan normally stops after a cycle of 14
+	 records and never goes past the chunk's start, so this is one pass over
+	 each stream at most, and frames that go quiet for any length of time
+	 carry over correctly.
+	 */
+	size_t chunk = 0;
+	for (size_t i = 0; i < streamCount; i++) {
+		const GenericDashRecord* records = streams[i].records;
+		GenericDashContext seed;
+		initGenericDashContext(&seed);
+		for (size_t first = 0; first < streams[i].recordCount; first += chunkRecords) {
+			size_t last = first + chunkRecords < streams[i].recordCount ? first + chunkRecords : streams[i].recordCount;
+			chunks[chunk].stream = &streams[i];
+			chunks[chunk].first = first;
+			chunks[chunk].last = last;
+			chunks[chunk].seed = seed;
+			chunk++;
+
+			uint16_t seen = 0;
+			for (size_t j = last; j > first && seen != (1 << Generic_Dash_Frame_Count) - 1; j--) {
+				const unsigned char* frame = records[j - 1].frame;
+				if (frame[0] >= Generic_Dash_Frame_Count || (seen & (1 << frame[0]))) continue;
+				if (parseGenericDashContextCanFrame(&seed, frame)) seen |= 1 << frame[0];
+			}
+		}
+	}
+
+	GenericDashFleetPool pool = { chunks, queues, threadCount };
+	for (unsigned int i = 0; i < threadCount; i++) {
+		uint64_t first = chunkCount * i / threadCount;
+		uint64_t end = chunkCount * (i + 1) / threadCount;
+		atomic_init(&queues[i].range, (first << 32) | end);
+		workers[i].pool = &pool;
+		workers[i].worker = i;
+	}
+
+	// The calling thread is worker 0, anything that fails to start has its work stolen
+	unsigned int started = 1;
+	for (; started < threadCount; started++)
+		if (pthread_create(&threads[started], NULL, runGenericDashFleetWorker, &workers[started]) != 0) break;
+	runGenericDashFleetWorker(&workers[0]);
+	for (unsigned int i = 1; i < started; i++) pthread_join(threads[i], NULL);
+
+	// Totals are summed in chunk order once everything is done so they never depend on scheduling
+	for (size_t i = 0; i < streamCount; i++) streams[i].acceptedFrames = 0;
+	for (size_t i = 0; i < chunkCount; i++) chunks[i].stream->acceptedFrames += chunks[i].acceptedFrames;
+
+	free(chunks);
+	free(queues);
+	free(workers);
+	free(threads);
+	return true;
+}
+
+#endif // GENERIC_DASH_FLEET_DECODER
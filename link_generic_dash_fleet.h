@@ -0,0 +1,73 @@
+/*
+ link_generic_dash_fleet.h - Multi-core batch decoder for Generic Dash logs
+ For copyright and license information see LICENSE
+
+ Decodes many recorded Generic Dash streams at once, ie. a night's worth of
+ logs from a fleet of cars, into one column of values per parameter with a
+ row for every record. Each stream is cut into chunks that are shared out
+ between worker threads, and a thread that runs out of chunks steals from
+ the others so one long log doesn't hold everything up.
+
+ Every chunk is decoded by decodeGenericDashBatch with its own context. Before
+ the threads start, each chunk's context is seeded with the state a decoder
+ would be in at its first record, carried forward chunk by chunk from the
+ latest copy of each of the 14 frames in the chunk before (its keyframe), so
+ the results are exactly what decoding the whole stream in order would give
+ regardless of thread count or chunk size.
+
+ Only available where POSIX threads are, ie. Linux and macOS. Some optional
+ defines you can add before including this file:
+
+ #define NO_DASH_FLEET_DECODER
+ Will not include the fleet decoder even where POSIX threads are available.
+ */
+
+#ifndef link_generic_dash_fleet_h
+#define link_generic_dash_fleet_h
+
+#include "link_generic_dash.h"
+#include "link_generic_dash_batch.h"
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(NO_DASH_FLEET_DECODER)
+#define GENERIC_DASH_FLEET_DECODER
+#endif
+
+#ifdef GENERIC_DASH_FLEET_DECODER
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Default number of records decoded as a single unit of work
+ */
+#define defaultGenericDashFleetChunkRecords 65536
+
+/**
+ * @brief A single recorded stream to decode and where to put its values
+ */
+typedef struct {
+	const GenericDashRecord* records;
+	size_t recordCount;
+	float* columns[Generic_Dash_Parameter_Count]; // Each recordCount long, NULL to skip a parameter
+	uint16_t* rawColumns[Generic_Dash_Parameter_Count]; // Same again for raw values, NULL to skip a parameter
+	size_t acceptedFrames; // Filled in with the number of records that were valid frames
+} GenericDashFleetStream;
+
+/**
+ * @brief Decodes a set of streams across a pool of worker threads
+ * @param streams is an array of streams, each stream's columns get one value per record
+ * @param streamCount is the number of streams
+ * @param threadCount is the number of worker threads, 0 for one per online CPU
+ * @param chunkRecords is the number of records per unit of work, 0 for defaultGenericDashFleetChunkRecords
+ * @return true if every stream was decoded, false otherwise
+ */
+bool decodeGenericDashFleet(GenericDashFleetStream* streams, size_t streamCount, unsigned int threadCount, size_t chunkRecords);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // GENERIC_DASH_FLEET_DECODER
+
+#endif // link_generic_dash_fleet_h
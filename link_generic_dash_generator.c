@@ -0,0 +1,264 @@
+/*
+ Any additions to this file will need suitable additions to link_generic_dash_generator.h
+ For documentation please the above file.
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#include "link_generic_dash_generator.h"
+
+#ifdef GENERIC_DASH_GENERATOR_SOCKETCAN
+#include <errno.h>
+#include <time.h>
+#include <poll.h>
+#include <unistd.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <linux/can.h>
+#include <linux/can/raw.h>
+#endif
+
+/*
+ xorshift32, cheap and good enough for test data - state must never be 0
+ */
+static uint32_t nextGenericDashGeneratorRandom(GenericDashGenerator* generator) {
+	uint32_t x = generator->random;
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return generator->random = x;
+}
+
+static uint16_t randomGenericDashGeneratorValue(GenericDashGenerator* generator, GenericDashGeneratorChannel* channel) {
+	uint32_t range = (uint32_t)channel->maximum - channel->minimum + 1;
+	return (uint16_t)(channel->minimum + nextGenericDashGeneratorRandom(generator) % range);
+}
+
+static void rewindGenericDashGeneratorChannel(GenericDashGenerator* generator, GenericDashGeneratorChannel* channel) {
+	channel->held = 0;
+	channel->position = 0;
+	channel->descending = false;
+	switch (channel->profile) {
+		case GENERATOR_PROFILE_RANDOM:
+			channel->value = randomGenericDashGeneratorValue(generator, channel);
+			break;
+		case GENERATOR_PROFILE_SEQUENCE:
+			channel->value = channel->sequenceLength ? channel->sequence[0] : 0;
+			break;
+		default:
+			channel->value = channel->minimum;
+			break;
+	}
+}
+
+static void advanceGenericDashGeneratorChannel(GenericDashGenerator* generator, GenericDashGeneratorChannel* channel) {
+	if (++channel->held < channel->hold) return;
+	channel->held = 0;
+	switch (channel->profile) {
+		case GENERATOR_PROFILE_SWEEP:
+			if (channel->descending) {
+				if (channel->value - channel->minimum <= channel->step) {
+					channel->value = channel->minimum;
+					channel->descending = false;
+				} else {
+					channel->value -= channel->step;
+				}
+			} else {
+				if (channel->maximum - channel->value <= channel->step) {
+					channel->value = channel->maximum;
+					channel->descending = true;
+				} else {
+					channel->value += channel->step;
+				}
+			}
+			break;
+		case GENERATOR_PROFILE_RANDOM:
+			channel->value = randomGenericDashGeneratorValue(generator, channel);
+			break;
+		case GENERATOR_PROFILE_TOGGLE:
+			channel->value ^= channel->step;
+			break;
+		case GENERATOR_PROFILE_SEQUENCE:
+			if (channel->sequenceLength == 0) break;
+			if (++channel->position >= channel->sequenceLength) channel->position = 0;
+			channel->value = channel->sequence[channel->position];
+			break;
+		default:
+			break;
+	}
+}
+
+void initGenericDashGenerator(GenericDashGenerator* generator, uint32_t seed, uint32_t frameRateHz) {
+	memset(generator, 0, sizeof(*generator));
+	generator->seed = seed;
+	generator->frameRateHz = frameRateHz;
+	resetGenericDashGenerator(generator);
+}
+
+void resetGenericDashGenerator(GenericDashGenerator* generator) {
+	generator->random = generator->seed ? generator->seed : 0x9E3779B9;
+	generator->framesGenerated = 0;
+	generator->nextFrame = 0;
+	for (int i = 0; i < Generic_Dash_Parameter_Count; i++)
+		rewindGenericDashGeneratorChannel(generator, &generator->channels[i]);
+}
+
+bool setGenericDashGeneratorProfile(GenericDashGenerator* generator, GenericDashParameters param, GenericDashGeneratorProfiles profile, uint16_t minimum, uint16_t maximum, uint16_t step, uint16_t hold) {
+	if ((int)param < 0 || (int)param >= Generic_Dash_Parameter_Count) return false;
+	if (profile == GENERATOR_PROFILE_SEQUENCE || (profile != GENERATOR_PROFILE_TOGGLE && minimum > maximum)) return false;
+	GenericDashGeneratorChannel* channel = &generator->channels[param];
+	channel->profile = profile;
+	channel->minimum = minimum;
+	channel->maximum = maximum;
+	channel->step = step;
+	channel->hold = hold;
+	channel->sequence = NULL;
+	channel->sequenceLength = 0;
+	rewindGenericDashGeneratorChannel(generator, channel);
+	return true;
+}
+
+bool setGenericDashGeneratorSequence(GenericDashGenerator* generator, GenericDashParameters param, const uint16_t* sequence, uint16_t sequenceLength, uint16_t hold) {
+	if ((int)param < 0 || (int)param >= Generic_Dash_Parameter_Count) return false;
+	if (sequence == NULL || sequenceLength == 0) return false;
+	GenericDashGeneratorChannel* channel = &generator->channels[param];
+	channel->profile = GENERATOR_PROFILE_SEQUENCE;
+	channel->hold = hold;
+	channel->sequence = sequence;
+	channel->sequenceLength = sequenceLength;
+	rewindGenericDashGeneratorChannel(generator, channel);
+	return true;
+}
+
+void nextGenericDashGeneratorFrame(GenericDashGenerator* generator, GenericDashRecord* record) {
+	unsigned char index = generator->nextFrame;
+	GenericDashGeneratorChannel* channel = &generator->channels[index * 3];
+
+	/*
+	 Frames are evenly spread, so at 1 kHz per frame there is one frame every
+	 1000000 / (1000 * 14) microseconds - unpaced streams just tick 1us a frame
+	 */
+	if (generator->frameRateHz)
+		record->timestamp = generator->startTimestamp + generator->framesGenerated * 1000000 / ((uint64_t)generator->frameRateHz * Generic_Dash_Frame_Count);
+	else
+		record->timestamp = generator->startTimestamp + generator->framesGenerated;
+
+	record->frame[0] = index;
+	record->frame[1] = 0;
+	for (int i = 0; i < 3; i++) {
+		record->frame[2 + i * 2] = (unsigned char)(channel[i].value & 0xFF);
+		record->frame[3 + i * 2] = (unsigned char)(channel[i].value >> 8);
+		advanceGenericDashGeneratorChannel(generator, &channel[i]);
+	}
+
+	generator->framesGenerated++;
+	if (++generator->nextFrame >= Generic_Dash_Frame_Count) generator->nextFrame = 0;
+}
+
+size_t generateGenericDashFrames(GenericDashGenerator* generator, GenericDashRecord* records, size_t count) {
+	for (size_t i = 0; i < count; i++) nextGenericDashGeneratorFrame(generator, &records[i]);
+	return count;
+}
+
+static int writeGenericDashGeneratorDigits(char* output, uint64_t value, int digits) {
+	for (int i = digits - 1; i >= 0; i--) {
+		output[i] = (char)('0' + value % 10);
+		value /= 10;
+	}
+	return digits;
+}
+
+size_t writeGenericDashGeneratorLog(GenericDashGenerator* generator, FILE* file, const char* interface, unsigned int canId, size_t count) {
+	static const char hex[] = "0123456789ABCDEF";
+	GenericDashRecord record;
+	char line[96];
+	char interfaceAndId[48];
+	size_t written = 0;
+
+	// Only the timestamp and data change between lines, so the rest is formatted once up front. IDs
+	// above 0x7FF are sent as 29 bit extended frames, which candump writes as 8 hex digits.
+	int interfaceAndIdLength = canId > 0x7FF ? snprintf(interfaceAndId, sizeof(interfaceAndId), ") %s %08X#", interface, canId & 0x1FFFFFFF)
+	                                         : snprintf(interfaceAndId, sizeof(interfaceAndId), ") %s %03X#", interface, canId);
+	if (interfaceAndIdLength < 0 || interfaceAndIdLength >= (int)sizeof(interfaceAndId)) return 0;
+
+	for (; written < count; written++) {
+		nextGenericDashGeneratorFrame(generator, &record);
+		int length = 0;
+		line[length++] = '(';
+		length += writeGenericDashGeneratorDigits(line + length, (record.timestamp / 1000000) % 10000000000ULL, 10);
+		line[length++] = '.';
+		length += writeGenericDashGeneratorDigits(line + length, record.timestamp % 1000000, 6);
+		memcpy(line + length, interfaceAndId, interfaceAndIdLength);
+		length += interfaceAndIdLength;
+		for (int i = 0; i < 8; i++) {
+			line[length++] = hex[record.frame[i] >> 4];
+			line[length++] = hex[record.frame[i] & 0xF];
+		}
+		line[length++] = '\n';
+		if (fwrite(line, 1, length, file) != (size_t)length) break;
+	}
+	return written;
+}
+
+#ifdef GENERIC_DASH_GENERATOR_SOCKETCAN
+
+int openGenericDashGeneratorSocket(const char* interface) {
+	int socketFd = socket(PF_CAN, SOCK_RAW, CAN_RAW);
+	if (socketFd < 0) return -1;
+
+	struct sockaddr_can address;
+	memset(&address, 0, sizeof(address));
+	address.can_family = AF_CAN;
+	address.can_ifindex = if_nametoindex(interface);
+	if (address.can_ifindex == 0 || bind(socketFd, (struct sockaddr*)&address, sizeof(address)) < 0) {
+		close(socketFd);
+		return -1;
+	}
+	return socketFd;
+}
+
+size_t sendGenericDashGeneratorFrames(GenericDashGenerator* generator, int socketFd, unsigned int canId, size_t count) {
+	GenericDashRecord record;
+	struct can_frame frame;
+	struct timespec origin;
+	uint64_t firstTimestamp = 0;
+	size_t sent = 0;
+
+	memset(&frame, 0, sizeof(frame));
+	frame.can_id = canId > CAN_SFF_MASK ? (canId & CAN_EFF_MASK) | CAN_EFF_FLAG : canId;
+	frame.can_dlc = 8;
+	clock_gettime(CLOCK_MONOTONIC, &origin);
+
+	for (; sent < count; sent++) {
+		nextGenericDashGeneratorFrame(generator, &record);
+		memcpy(frame.data, record.frame, 8);
+
+		if (generator->frameRateHz) {
+			if (sent == 0) firstTimestamp = record.timestamp;
+			uint64_t offset = record.timestamp - firstTimestamp;
+			struct timespec due = origin;
+			due.tv_sec += offset / 1000000;
+			due.tv_nsec += (offset % 1000000) * 1000;
+			if (due.tv_nsec >= 1000000000) {
+				due.tv_sec++;
+				due.tv_nsec -= 1000000000;
+			}
+			while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &due, NULL) == EINTR);
+		}
+
+		// A full transmit queue is normal when unpaced, wait for room rather than drop
+		while (write(socketFd, &frame, sizeof(frame)) != sizeof(frame)) {
+			if (errno == ENOBUFS || errno == EAGAIN) {
+				struct pollfd waitFd = { socketFd, POLLOUT, 0 };
+				poll(&waitFd, 1, 10);
+			} else if (errno != EINTR) {
+				return sent;
+			}
+		}
+	}
+	return sent;
+}
+
+#endif // GENERIC_DASH_GENERATOR_SOCKETCAN
@@ -0,0 +1,170 @@
+/*
+ link_generic_dash_generator.h - Synthetic Generic Dash stream generator
+ For copyright and license information see LICENSE
+
+ Produces valid Generic Dash frame sequences so consumers of this library can
+ be load and soak tested without a real ECU. Every parameter is driven by its
+ own profile, for example an RPM sweep, a list of fault codes to inject or a
+ limit flag that toggles on and off.
+
+ Profiles work on raw values as sent on the wire, ie. before the scaling that
+ getGenericDashValue applies. An RPM sweep of 0 to 8000 is just that, but a
+ coolant temperature of 90°C is a raw value of 140 (offset of -50).
+
+ Given the same seed and profiles the generator always produces the same
+ stream, so a field bug can be reproduced by re-running with the same setup.
+
+ Some optional defines you can add before including this file:
+
+ #define NO_DASH_GENERATOR_SOCKETCAN
+ Will not include the SocketCAN (can0 / vcan0) output even on Linux, where
+ it is otherwise available.
+ */
+
+#ifndef link_generic_dash_generator_h
+#define link_generic_dash_generator_h
+
+#include "link_generic_dash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__linux__) && !defined(NO_DASH_GENERATOR_SOCKETCAN)
+#define GENERIC_DASH_GENERATOR_SOCKETCAN
+#endif
+
+/**
+ * @brief How a generated parameter changes each time its frame is sent
+ */
+typedef enum {
+	GENERATOR_PROFILE_CONSTANT, // Always minimum
+	GENERATOR_PROFILE_SWEEP,    // Up and down between minimum and maximum by step
+	GENERATOR_PROFILE_RANDOM,   // Random value between minimum and maximum
+	GENERATOR_PROFILE_TOGGLE,   // Starts at minimum, bits in step are flipped
+	GENERATOR_PROFILE_SEQUENCE, // Cycles through a list of values ie. fault codes
+} GenericDashGeneratorProfiles;
+
+/**
+ * @brief Profile and current state of a single generated parameter
+ */
+typedef struct {
+	GenericDashGeneratorProfiles profile;
+	uint16_t minimum;
+	uint16_t maximum;
+	uint16_t step;
+	uint16_t hold; // Number of frames to hold each value for, 0 or 1 to change every frame
+	const uint16_t* sequence;
+	uint16_t sequenceLength;
+
+	// Current state, rewound by resetGenericDashGenerator
+	uint16_t value;
+	uint16_t held;
+	uint16_t position;
+	bool descending;
+} GenericDashGeneratorChannel;
+
+/**
+ * @brief A synthetic Generic Dash stream
+ */
+typedef struct {
+	GenericDashGeneratorChannel channels[Generic_Dash_Parameter_Count];
+	uint32_t seed;
+	uint32_t random;
+	uint32_t frameRateHz; // Rate of each of the 14 frames, 0 for as fast as possible
+	uint64_t startTimestamp;
+	uint64_t framesGenerated;
+	unsigned char nextFrame;
+} GenericDashGenerator;
+
+/**
+ * @brief Sets up a generator with every parameter held at a raw value of 0
+ * @param generator is the generator to set up
+ * @param seed is the random seed, any value including 0 is fine
+ * @param frameRateHz is the rate each frame is sent at, 0 for as fast as possible
+ */
+void initGenericDashGenerator(GenericDashGenerator* generator, uint32_t seed, uint32_t frameRateHz);
+
+/**
+ * @brief Rewinds a generator to its first frame so the same stream is produced again
+ * @param generator is the generator to rewind
+ */
+void resetGenericDashGenerator(GenericDashGenerator* generator);
+
+/**
+ * @brief Sets the profile of a single generated parameter and rewinds that parameter
+ * @param generator is the generator to change
+ * @param param is one of enum GenericDashParameters to change
+ * @param profile is one of enum GenericDashGeneratorProfiles
+ * @param minimum is the lowest raw value, or the starting raw value for GENERATOR_PROFILE_TOGGLE
+ * @param maximum is the highest raw value
+ * @param step is the amount to sweep by, or the bits to flip for GENERATOR_PROFILE_TOGGLE
+ * @param hold is the number of frames to hold each value for
+ * @return true if the profile was set, false otherwise
+ */
+bool setGenericDashGeneratorProfile(GenericDashGenerator* generator, GenericDashParameters param, GenericDashGeneratorProfiles profile, uint16_t minimum, uint16_t maximum, uint16_t step, uint16_t hold);
+
+/**
+ * @brief Sets a parameter to cycle through a list of raw values, ie. to inject fault codes
+ * @param generator is the generator to change
+ * @param param is one of enum GenericDashParameters to change
+ * @param sequence is the list of raw values, which must outlive the generator
+ * @param sequenceLength is the number of values in sequence
+ * @param hold is the number of frames to hold each value for
+ * @return true if the sequence was set, false otherwise
+ */
+bool setGenericDashGeneratorSequence(GenericDashGenerator* generator, GenericDashParameters param, const uint16_t* sequence, uint16_t sequenceLength, uint16_t hold);
+
+/**
+ * @brief Generates the next frame of the stream, frames are sent in order 0 to 13
+ * @param generator is the generator to advance
+ * @param record is filled with the frame and the time it would be sent at
+ */
+void nextGenericDashGeneratorFrame(GenericDashGenerator* generator, GenericDashRecord* record);
+
+/**
+ * @brief Generates frames into a memory buffer
+ * @param generator is the generator to advance
+ * @param records is an array of at least count records to fill
+ * @param count is the number of frames to generate
+ * @return size_t number of frames generated
+ */
+size_t generateGenericDashFrames(GenericDashGenerator* generator, GenericDashRecord* records, size_t count);
+
+/**
+ * @brief Generates frames as a candump -l log, which candump, canplayer and the like can record and replay
+ * @param generator is the generator to advance
+ * @param file is an open file to write to
+ * @param interface is the interface name to record against ie. "vcan0"
+ * @param canId is the CAN ID to record against, normally defaultGenericDashCanId, anything above 0x7FF is written as an extended ID
+ * @param count is the number of frames to generate
+ * @return size_t number of frames written
+ */
+size_t writeGenericDashGeneratorLog(GenericDashGenerator* generator, FILE* file, const char* interface, unsigned int canId, size_t count);
+
+#ifdef GENERIC_DASH_GENERATOR_SOCKETCAN
+
+/**
+ * @brief Opens a raw SocketCAN socket for sending generated frames
+ * @param interface is the interface name ie. "vcan0"
+ * @return int socket file descriptor or -1 on failure
+ */
+int openGenericDashGeneratorSocket(const char* interface);
+
+/**
+ * @brief Sends generated frames to a SocketCAN socket, paced to frameRateHz unless that is 0
+ * @param generator is the generator to advance
+ * @param socketFd is a socket from openGenericDashGeneratorSocket
+ * @param canId is the CAN ID to send on, normally defaultGenericDashCanId
+ * @param count is the number of frames to send
+ * @return size_t number of frames sent, less than count on failure
+ */
+size_t sendGenericDashGeneratorFrames(GenericDashGenerator* generator, int socketFd, unsigned int canId, size_t count);
+
+#endif // GENERIC_DASH_GENERATOR_SOCKETCAN
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // link_generic_dash_generator_h
@@ -0,0 +1,517 @@
+/*
+ Any additions to this file will need suitable additions to link_generic_dash_import.h
+ For documentation please the above file.
+ */
+
+#ifdef __linux__
+#define _GNU_SOURCE
+#endif
+
+#include "link_generic_dash_import.h"
+
+#include <stddef.h>
+
+#ifdef GENERIC_DASH_IMPORT_FILES
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/*
+ Hex digit value plus one for every character, 0 if it isn't a hex digit
+ */
+static const unsigned char GenericDashImportHex[256] = {
+	['0'] = 1, ['1'] = 2, ['2'] = 3, ['3'] = 4, ['4'] = 5, ['5'] = 6, ['6'] = 7, ['7'] = 8, ['8'] = 9, ['9'] = 10,
+	['A'] = 11, ['B'] = 12, ['C'] = 13, ['D'] = 14, ['E'] = 15, ['F'] = 16,
+	['a'] = 11, ['b'] = 12, ['c'] = 13, ['d'] = 14, ['e'] = 15, ['f'] = 16,
+};
+
+typedef enum {
+	IMPORT_LINE_RECORD,   // A Generic Dash frame
+	IMPORT_LINE_OTHER_ID, // A valid frame with another CAN ID
+	IMPORT_LINE_SKIPPED,  // Anything else
+} GenericDashImportLines;
+
+static inline bool isGenericDashImportDigit(char c) {
+	return (unsigned char)(c - '0') < 10;
+}
+
+/*
+ IDs above 0x7FF can only be extended, and a standard ID only matches standard
+ frames, the same as the event loop's kernel filter
+ */
+static inline bool isGenericDashImportExtended(const GenericDashImporter* importer) {
+	return importer->canId > 0x7FF;
+}
+
+static inline const char* skipGenericDashImportSpaces(const char* p, const char* end) {
+	while (p < end && (*p == ' ' || *p == '\t')) p++;
+	return p;
+}
+
+static bool startsGenericDashImportWord(const char* p, const char* end, const char* word) {
+	size_t length = strlen(word);
+	return (size_t)(end - p) >= length && memcmp(p, word, length) == 0;
+}
+
+/*
+ Reads "seconds.fraction" as microseconds, any digits past the sixth are ignored
+ */
+static const char* scanGenericDashImportTimestamp(const char* p, const char* end, uint64_t* timestamp) {
+	const char* start = p;
+	uint64_t seconds = 0;
+	while (p < end && isGenericDashImportDigit(*p)) seconds = seconds * 10 + (uint64_t)(*p++ - '0');
+	if (p == start || p >= end || *p != '.') return NULL;
+	p++;
+
+	uint64_t fraction = 0;
+	int digits = 0;
+	for (; p < end && isGenericDashImportDigit(*p); p++) {
+		if (digits < 6) {
+			fraction = fraction * 10 + (uint64_t)(*p - '0');
+			digits++;
+		}
+	}
+	for (; digits < 6; digits++) fraction *= 10;
+	*timestamp = seconds * 1000000 + fraction;
+	return p;
+}
+
+/*
+ Reads 8 data bytes written as 16 hex digits, optionally with a separator after each byte
+ */
+static bool scanGenericDashImportData(const char* p, const char* end, int stride, unsigned char frame[8]) {
+	if (end - p < 7 * stride + 2) return false;
+	unsigned char valid = 1;
+	for (int i = 0; i < 8; i++, p += stride) {
+		unsigned char high = GenericDashImportHex[(unsigned char)p[0]];
+		unsigned char low = GenericDashImportHex[(unsigned char)p[1]];
+		frame[i] = (unsigned char)(((high - 1) << 4) | (low - 1));
+		valid &= (high != 0) & (low != 0);
+	}
+	return valid;
+}
+
+/*
+ Reads 8 digits at once on little-endian hosts, see "Faster Integer Parsing"
+ by Daniel Lemire and Wojciech Muła for how this works
+ */
+static inline bool scanGenericDashImportEightDigits(const char* p, uint32_t* value) {
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__)
+	uint64_t chunk;
+	memcpy(&chunk, p, sizeof(chunk));
+	// Every high nibble must be 3, and still 3 after adding 6 to rule out ':' to '?'
+	if (((chunk & 0xF0F0F0F0F0F0F0F0ULL) | (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) != 0x3333333333333333ULL) return false;
+	chunk -= 0x3030303030303030ULL;
+	chunk = (chunk * 10) + (chunk >> 8);
+	chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) + (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+	*value = (uint32_t)chunk;
+#else
+	*value = 0;
+	for (int i = 0; i < 8; i++) {
+		if (!isGenericDashImportDigit(p[i])) return false;
+		*value = *value * 10 + (uint32_t)(p[i] - '0');
+	}
+#endif
+	return true;
+}
+
+/*
+ Nearly every candump log has 10 digit seconds, "(1436509052.249713)", so
+ those are read without a loop. Needs 20 readable characters from p.
+ */
+static inline bool scanGenericDashImportCandumpTimestamp(const char* p, uint64_t* timestamp) {
+	if (p[11] != '.' || p[18] != ')' || !isGenericDashImportDigit(p[9]) || !isGenericDashImportDigit(p[10])) return false;
+
+	char micros[8];
+	memcpy(micros, p + 12, 6);
+	micros[6] = micros[7] = '0';
+	uint32_t seconds, fraction;
+	if (!scanGenericDashImportEightDigits(p + 1, &seconds) || !scanGenericDashImportEightDigits(micros, &fraction)) return false;
+	*timestamp = ((uint64_t)seconds * 100 + (uint64_t)(p[9] - '0') * 10 + (uint64_t)(p[10] - '0')) * 1000000 + fraction / 100;
+	return true;
+}
+
+static inline const char* nextGenericDashImportLine(const char* p, const char* limit) {
+	const char* newline = memchr(p, '\n', limit - p);
+	return newline != NULL ? newline + 1 : limit;
+}
+
+/*
+ (1436509052.249713) can0 3E8#0000E8030000FA00
+
+ Lines are parsed straight from the text without finding where they end
+ first, the newline is only searched for when a line turns out not to be a
+ Generic Dash frame. Sets next to the start of the following line.
+ */
+static GenericDashImportLines parseGenericDashImportCandump(GenericDashImporter* importer, const char* p, const char* limit, GenericDashRecord* record, const char** next) {
+	if (*p != '(') goto skipped;
+	if (limit - p >= 20 && scanGenericDashImportCandumpTimestamp(p, &record->timestamp)) {
+		p += 19;
+	} else {
+		// Kept apart from p so a line that isn't a timestamp still skips from a valid pointer
+		const char* timestampEnd = scanGenericDashImportTimestamp(p + 1, limit, &record->timestamp);
+		if (timestampEnd == NULL || timestampEnd >= limit || *timestampEnd != ')') goto skipped;
+		p = timestampEnd + 1;
+	}
+	if (p >= limit || *p != ' ') goto skipped;
+
+	// Interface name
+	p++;
+	while (p < limit && *p != ' ' && *p != '\n') p++;
+	if (p >= limit || *p != ' ') goto skipped;
+	p++;
+
+	unsigned int id = 0;
+	int digits = 0;
+	for (; p < limit && digits <= 8; p++, digits++) {
+		unsigned char value = GenericDashImportHex[(unsigned char)*p];
+		if (value == 0) break;
+		id = (id << 4) | (value - 1);
+	}
+	if (digits == 0 || digits > 8 || p >= limit || *p != '#') goto skipped;
+	// candump writes standard IDs as 3 digits and extended ones as 8, so 3E8 and 000003E8 are different frames
+	if (id != importer->canId || (digits > 3) != isGenericDashImportExtended(importer)) {
+		*next = nextGenericDashImportLine(p, limit);
+		return IMPORT_LINE_OTHER_ID;
+	}
+
+	// Exactly 16 hex digits, which rules out remote ("#R") and CAN FD ("##") frames
+	p++;
+	if (limit - p < 16 || !scanGenericDashImportData(p, limit, 2, record->frame)) goto skipped;
+	const char* end = p + 16;
+	if (end < limit && *end == '\r') end++;
+	if (end < limit && *end != '\n') goto skipped;
+	*next = end < limit ? end + 1 : limit;
+	return IMPORT_LINE_RECORD;
+
+skipped:
+	*next = nextGenericDashImportLine(p, limit);
+	return IMPORT_LINE_SKIPPED;
+}
+
+/*
+    12.345678 1  3E8             Rx   d 8 00 00 E8 03 00 00 FA 00  Length = 0 BitCount = 0 ID = 1000
+ */
+static GenericDashImportLines parseGenericDashImportAsc(GenericDashImporter* importer, const char* p, const char* end, GenericDashRecord* record) {
+	p = skipGenericDashImportSpaces(p, end);
+	if (p >= end) return IMPORT_LINE_SKIPPED;
+
+	if (!isGenericDashImportDigit(*p)) {
+		// Header, ie. "base hex  timestamps absolute"
+		if (startsGenericDashImportWord(p, end, "base ")) {
+			p = skipGenericDashImportSpaces(p + 5, end);
+			importer->decimalIds = startsGenericDashImportWord(p, end, "dec");
+			while (p < end && *p != ' ' && *p != '\t') p++;
+			p = skipGenericDashImportSpaces(p, end);
+			if (startsGenericDashImportWord(p, end, "timestamps "))
+				importer->relativeTimestamps = startsGenericDashImportWord(skipGenericDashImportSpaces(p + 11, end), end, "relative");
+		}
+		return IMPORT_LINE_SKIPPED;
+	}
+
+	uint64_t timestamp;
+	p = scanGenericDashImportTimestamp(p, end, &timestamp);
+	if (p == NULL) return IMPORT_LINE_SKIPPED;
+	if (importer->relativeTimestamps) {
+		timestamp += importer->previousTimestamp;
+		importer->previousTimestamp = timestamp;
+	}
+	record->timestamp = timestamp;
+
+	// Channel, then the CAN ID - anything else here is an event like "ErrorFrame"
+	p = skipGenericDashImportSpaces(p, end);
+	if (p >= end || !isGenericDashImportDigit(*p)) return IMPORT_LINE_SKIPPED;
+	while (p < end && isGenericDashImportDigit(*p)) p++;
+	p = skipGenericDashImportSpaces(p, end);
+
+	unsigned int id = 0;
+	int digits = 0;
+	for (; p < end && digits <= 10; p++, digits++) {
+		unsigned char value = importer->decimalIds ? (isGenericDashImportDigit(*p) ? (unsigned char)(*p - '0' + 1) : 0) : GenericDashImportHex[(unsigned char)*p];
+		if (value == 0) break;
+		id = id * (importer->decimalIds ? 10 : 16) + (value - 1);
+	}
+	if (digits == 0 || digits > 10) return IMPORT_LINE_SKIPPED;
+	bool extended = p < end && *p == 'x';
+	if (extended) p++;
+	if (p >= end || (*p != ' ' && *p != '\t')) return IMPORT_LINE_SKIPPED;
+	if (id != importer->canId || extended != isGenericDashImportExtended(importer)) return IMPORT_LINE_OTHER_ID;
+
+	// Direction, then "d 8" for an 8 byte data frame
+	p = skipGenericDashImportSpaces(p, end);
+	if (!startsGenericDashImportWord(p, end, "Rx") && !startsGenericDashImportWord(p, end, "Tx")) return IMPORT_LINE_SKIPPED;
+	p = skipGenericDashImportSpaces(p + 2, end);
+	if (end - p < 3 || p[0] != 'd' || (p[1] != ' ' && p[1] != '\t')) return IMPORT_LINE_SKIPPED;
+	p = skipGenericDashImportSpaces(p + 1, end);
+	if (end - p < 2 || p[0] != '8' || (p[1] != ' ' && p[1] != '\t')) return IMPORT_LINE_SKIPPED;
+	p = skipGenericDashImportSpaces(p + 1, end);
+
+	if (!scanGenericDashImportData(p, end, 3, record->frame)) return IMPORT_LINE_SKIPPED;
+	for (int i = 1; i < 8; i++)
+		if (p[i * 3 - 1] != ' ') return IMPORT_LINE_SKIPPED;
+	return IMPORT_LINE_RECORD;
+}
+
+static void detectGenericDashImportFormat(GenericDashImporter* importer, const char* text, size_t length) {
+	const char* p = text;
+	const char* end = text + length;
+	while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+	importer->format = (p < end && *p == '(') ? IMPORT_FORMAT_CANDUMP : IMPORT_FORMAT_ASC;
+}
+
+static bool flushGenericDashImportBatch(GenericDashImporter* importer, const GenericDashRecord* records, size_t count) {
+	if (count == 0) return true;
+	if (importer->context != NULL)
+		for (size_t i = 0; i < count; i++) parseGenericDashContextCanFrame(importer->context, records[i].frame);
+	importer->records += count;
+	if (importer->callback != NULL && !importer->callback(importer, records, count)) {
+		importer->stopped = true;
+		return false;
+	}
+	return true;
+}
+
+void initGenericDashImporter(GenericDashImporter* importer, GenericDashImportFormats format, unsigned int canId, GenericDashImportCallback callback, void* user) {
+	memset(importer, 0, offsetof(GenericDashImporter, batch));
+	importer->format = format;
+	importer->canId = canId;
+	importer->callback = callback;
+	importer->user = user;
+}
+
+size_t importGenericDashText(GenericDashImporter* importer, const char* text, size_t length, bool final) {
+	GenericDashRecord* batch = importer->batch;
+	size_t batchCount = 0;
+
+	if (importer->stopped) return 0;
+	if (importer->format == IMPORT_FORMAT_AUTO) {
+		if (!final && memchr(text, '\n', length) == NULL) return 0;
+		detectGenericDashImportFormat(importer, text, length);
+	}
+	bool candump = importer->format == IMPORT_FORMAT_CANDUMP;
+
+	// Only whole lines are imported unless this is the end of the log
+	const char* limit = text + length;
+	if (!final)
+		while (limit > text && limit[-1] != '\n') limit--;
+
+	const char* p = text;
+	while (p < limit) {
+		const char* next;
+		GenericDashImportLines result;
+		if (candump) {
+			if (*p == '\n' || *p == '\r') {
+				p++;
+				continue;
+			}
+			result = parseGenericDashImportCandump(importer, p, limit, &batch[batchCount], &next);
+		} else {
+			const char* newline = memchr(p, '\n', limit - p);
+			const char* end = newline != NULL ? newline : limit;
+			next = newline != NULL ? newline + 1 : limit;
+			if (end > p && end[-1] == '\r') end--;
+			if (end == p) {
+				p = next;
+				continue;
+			}
+			result = parseGenericDashImportAsc(importer, p, end, &batch[batchCount]);
+		}
+		importer->lines++;
+		p = next;
+
+		if (result == IMPORT_LINE_SKIPPED) {
+			importer->skippedLines++;
+		} else if (result == IMPORT_LINE_RECORD && ++batchCount == maxGenericDashImportBatch) {
+			if (!flushGenericDashImportBatch(importer, batch, batchCount)) return (size_t)(p - text);
+			batchCount = 0;
+		}
+	}
+	flushGenericDashImportBatch(importer, batch, batchCount);
+	return (size_t)(limit - text);
+}
+
+bool importGenericDashStream(GenericDashImporter* importer, FILE* file) {
+	char* buffer = malloc(defaultGenericDashImportChunkSize);
+	if (buffer == NULL) return false;
+
+	size_t filled = 0;
+	bool success = true;
+	for (;;) {
+		size_t bytesRead = fread(buffer + filled, 1, defaultGenericDashImportChunkSize - filled, file);
+		filled += bytesRead;
+		bool final = bytesRead == 0;
+		size_t used = importGenericDashText(importer, buffer, filled, final);
+		if (importer->stopped || final) break;
+
+		// A single line longer than the whole buffer can't be anything we're after
+		if (used == 0 && filled == defaultGenericDashImportChunkSize) {
+			importer->lines++;
+			importer->skippedLines++;
+			const char* newline = memchr(buffer, '\n', filled);
+			used = newline != NULL ? (size_t)(newline - buffer) + 1 : filled;
+		}
+		memmove(buffer, buffer + used, filled - used);
+		filled -= used;
+	}
+	if (ferror(file) || importer->stopped) success = false;
+	free(buffer);
+	return success;
+}
+
+#ifdef GENERIC_DASH_IMPORT_FILES
+
+typedef struct {
+	GenericDashImporter importer;
+	const char* text;
+	size_t length;
+	GenericDashRecord* records;
+	size_t recordCount;
+	size_t recordCapacity;
+	bool failed;
+} GenericDashImportWindow;
+
+static bool collectGenericDashImportWindow(GenericDashImporter* importer, const GenericDashRecord* records, size_t count) {
+	GenericDashImportWindow* window = (GenericDashImportWindow*)importer->user;
+	if (window->recordCount + count > window->recordCapacity) {
+		size_t capacity = window->recordCapacity ? window->recordCapacity * 2 : 65536;
+		while (capacity < window->recordCount + count) capacity *= 2;
+		GenericDashRecord* grown = realloc(window->records, capacity * sizeof(GenericDashRecord));
+		if (grown == NULL) {
+			window->failed = true;
+			return false;
+		}
+		window->records = grown;
+		window->recordCapacity = capacity;
+	}
+	memcpy(&window->records[window->recordCount], records, count * sizeof(GenericDashRecord));
+	window->recordCount += count;
+	return true;
+}
+
+static void* runGenericDashImportWindow(void* argument) {
+	GenericDashImportWindow* window = (GenericDashImportWindow*)argument;
+	importGenericDashText(&window->importer, window->text, window->length, true);
+	return NULL;
+}
+
+/*
+ Cuts the file into one window per thread, each ending on a line boundary, and
+ parses them all at once. Records are handed over in window order once every
+ thread has finished, then the next set of windows is started.
+ */
+static bool importGenericDashWindows(GenericDashImporter* importer, const char* text, size_t length, unsigned int threadCount) {
+	GenericDashImportWindow* windows = calloc(threadCount, sizeof(GenericDashImportWindow));
+	pthread_t* threads = calloc(threadCount, sizeof(pthread_t));
+	bool success = windows != NULL && threads != NULL;
+
+	size_t position = 0;
+	while (success && position < length) {
+		unsigned int windowCount = 0;
+		for (; windowCount < threadCount && position < length; windowCount++) {
+			GenericDashImportWindow* window = &windows[windowCount];
+			size_t end = length - position > defaultGenericDashImportWindowSize ? position + defaultGenericDashImportWindowSize : length;
+			const char* newline = end < length ? memchr(text + end, '\n', length - end) : NULL;
+			end = newline != NULL ? (size_t)(newline - text) + 1 : length;
+
+			window->importer = *importer;
+			window->importer.callback = collectGenericDashImportWindow;
+			window->importer.user = window;
+			window->importer.context = NULL;
+			window->importer.lines = window->importer.records = window->importer.skippedLines = 0;
+			window->text = text + position;
+			window->length = end - position;
+			window->recordCount = 0;
+			position = end;
+		}
+
+		unsigned int started = 1;
+		for (; started < windowCount; started++)
+			if (pthread_create(&threads[started], NULL, runGenericDashImportWindow, &windows[started]) != 0) break;
+		runGenericDashImportWindow(&windows[0]);
+		for (unsigned int i = 1; i < started; i++) pthread_join(threads[i], NULL);
+		for (unsigned int i = started; i < windowCount; i++) runGenericDashImportWindow(&windows[i]);
+
+		for (unsigned int i = 0; i < windowCount && success; i++) {
+			GenericDashImportWindow* window = &windows[i];
+			if (window->failed) {
+				success = false;
+				break;
+			}
+			importer->lines += window->importer.lines;
+			importer->skippedLines += window->importer.skippedLines;
+			for (size_t first = 0; first < window->recordCount && success; first += maxGenericDashImportBatch) {
+				size_t count = window->recordCount - first < maxGenericDashImportBatch ? window->recordCount - first : maxGenericDashImportBatch;
+				success = flushGenericDashImportBatch(importer, &window->records[first], count);
+			}
+		}
+	}
+
+	if (windows != NULL)
+		for (unsigned int i = 0; i < threadCount; i++) free(windows[i].records);
+	free(windows);
+	free(threads);
+	return success;
+}
+
+bool importGenericDashFile(GenericDashImporter* importer, const char* path, unsigned int threadCount) {
+	int fd = open(path, O_RDONLY);
+	if (fd < 0) return false;
+
+	struct stat status;
+	if (fstat(fd, &status) < 0) {
+		close(fd);
+		return false;
+	}
+	size_t length = (size_t)status.st_size;
+	if (length == 0) {
+		close(fd);
+		return true;
+	}
+
+	const char* text = mmap(NULL, length, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+	if (text == MAP_FAILED) return false;
+	madvise((void*)text, length, MADV_SEQUENTIAL);
+
+	if (threadCount == 0) {
+		long online = sysconf(_SC_NPROCESSORS_ONLN);
+		threadCount = online > 0 ? (unsigned int)online : 1;
+	}
+
+	/*
+	 Threads need to know the format and the ASC header up front, so work
+	 those out from the lines before the first frame
+	 */
+	if (importer->format == IMPORT_FORMAT_AUTO) detectGenericDashImportFormat(importer, text, length);
+	if (importer->format == IMPORT_FORMAT_ASC) {
+		const char* line = text;
+		const char* end = text + length;
+		while (line < end) {
+			const char* newline = memchr(line, '\n', end - line);
+			const char* lineEnd = newline != NULL ? newline : end;
+			const char* first = skipGenericDashImportSpaces(line, lineEnd);
+			if (first < lineEnd && isGenericDashImportDigit(*first)) break;
+			GenericDashRecord unused;
+			parseGenericDashImportAsc(importer, line, lineEnd, &unused);
+			line = lineEnd + 1;
+		}
+		// Each line's time depends on the one before, so these can't be split up
+		if (importer->relativeTimestamps) threadCount = 1;
+	}
+
+	bool success;
+	if (threadCount > 1 && length > defaultGenericDashImportWindowSize) {
+		success = importGenericDashWindows(importer, text, length, threadCount);
+	} else {
+		importGenericDashText(importer, text, length, true);
+		success = !importer->stopped;
+	}
+
+	munmap((void*)text, length);
+	return success;
+}
+
+#endif // GENERIC_DASH_IMPORT_FILES
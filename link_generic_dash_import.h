@@ -0,0 +1,153 @@
+/*
+ link_generic_dash_import.h - Fast importer for candump and Vector ASC text logs
+ For copyright and license information see LICENSE
+
+ Reads Generic Dash frames out of text CAN logs without sscanf, for turning
+ gigabytes of historical logs into records for the batch decoder. Two formats
+ are understood:
+
+ - candump -l, ie. "(1436509052.249713) can0 3E8#0000E8030000FA00"
+ - Vector ASC, ie. "   12.345678 1  3E8   Rx   d 8 00 00 E8 03 00 00 FA 00"
+   including the "base hex|dec" and "timestamps absolute|relative" header
+
+ Every line is checked against the Generic Dash CAN ID before anything else
+ is decoded, so traffic from the rest of the bus costs very little. Extended
+ IDs, 8 digits in candump or ending in "x" in ASC, never match a standard one. Matching
+ frames are gathered into batches of records, held in the importer rather
+ than on the stack which makes it about 16 KB, and handed to a callback, and
+ can also be parsed straight into a decoder context. Lines that aren't a
+ valid 8 byte data frame, ie. remote, error and CAN FD frames or headers, are
+ counted and skipped.
+
+ Text can be fed in a piece at a time from anywhere, read from a FILE*, or on
+ POSIX systems a whole file can be memory mapped and split between threads.
+ Some optional defines you can add before including this file:
+
+ #define NO_DASH_IMPORT_FILES
+ Will not include importGenericDashFile even where mmap and POSIX threads are
+ available.
+ */
+
+#ifndef link_generic_dash_import_h
+#define link_generic_dash_import_h
+
+#include "link_generic_dash.h"
+
+#if (defined(__unix__) || defined(__APPLE__)) && !defined(NO_DASH_IMPORT_FILES)
+#define GENERIC_DASH_IMPORT_FILES
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of records handed to the callback at a time
+ */
+#define maxGenericDashImportBatch 1024
+
+/**
+ * @brief Size of each read by importGenericDashStream
+ */
+#define defaultGenericDashImportChunkSize (1024 * 1024)
+
+/**
+ * @brief Amount of a file each thread parses at a time in importGenericDashFile
+ */
+#define defaultGenericDashImportWindowSize (16 * 1024 * 1024)
+
+/**
+ * @brief Text log formats that can be imported
+ */
+typedef enum {
+	IMPORT_FORMAT_AUTO,    // Worked out from the first text imported
+	IMPORT_FORMAT_CANDUMP, // candump -l
+	IMPORT_FORMAT_ASC,     // Vector ASC
+} GenericDashImportFormats;
+
+typedef struct GenericDashImporter GenericDashImporter;
+
+/**
+ * @brief Called with each batch of Generic Dash frames imported, in the order they appear in the log
+ * @param importer is the importer the records came from
+ * @param records are the frames and their timestamps in microseconds
+ * @param count is the number of records, up to maxGenericDashImportBatch
+ * @return true to carry on importing, false to stop
+ */
+typedef bool (*GenericDashImportCallback)(GenericDashImporter* importer, const GenericDashRecord* records, size_t count);
+
+/**
+ * @brief Importer settings and running totals
+ */
+struct GenericDashImporter {
+	GenericDashImportFormats format;
+	unsigned int canId;
+	GenericDashImportCallback callback;
+	void* user; // Anything you like, ie. where records are being collected
+	GenericDashContext* context; // Every record is parsed into this too if set, NULL by default
+
+	// ASC header settings, read from the log
+	bool decimalIds;
+	bool relativeTimestamps;
+	uint64_t previousTimestamp;
+
+	// Totals
+	uint64_t lines;
+	uint64_t records;
+	uint64_t skippedLines; // Lines that weren't a data frame, other CAN IDs are not counted
+	bool stopped; // The callback asked to stop
+
+	GenericDashRecord batch[maxGenericDashImportBatch]; // Records gathered for the next callback
+};
+
+/**
+ * @brief Sets up an importer
+ * @param importer is the importer to set up
+ * @param format is one of enum GenericDashImportFormats, IMPORT_FORMAT_AUTO to work it out
+ * @param canId is the Generic Dash CAN ID to import, normally defaultGenericDashCanId. IDs above 0x7FF
+ * only match extended frames, anything else only matches standard frames.
+ * @param callback is called with each batch of records, or NULL
+ * @param user is stored in the importer for use by the callback
+ */
+void initGenericDashImporter(GenericDashImporter* importer, GenericDashImportFormats format, unsigned int canId, GenericDashImportCallback callback, void* user);
+
+/**
+ * @brief Imports every complete line in a piece of text
+ * @param importer is the importer to use
+ * @param text is the text to import, it does not need to be null terminated
+ * @param length is the length of text
+ * @param final is true if this is the end of the log, so a last line without a newline is imported too
+ * @return size_t number of bytes used, anything after that is an incomplete line to pass in again with the next piece
+ */
+size_t importGenericDashText(GenericDashImporter* importer, const char* text, size_t length, bool final);
+
+/**
+ * @brief Imports a whole log from an open file in defaultGenericDashImportChunkSize pieces
+ * @param importer is the importer to use
+ * @param file is an open file to read to the end
+ * @return true if the whole file was read, false on a read or memory error or if the callback stopped it
+ */
+bool importGenericDashStream(GenericDashImporter* importer, FILE* file);
+
+#ifdef GENERIC_DASH_IMPORT_FILES
+
+/**
+ * @brief Memory maps and imports a whole log, optionally parsing it across several threads
+ *
+ * The callback is only ever called from the calling thread, in log order. ASC
+ * logs with relative timestamps are always imported on a single thread.
+ *
+ * @param importer is the importer to use
+ * @param path is the log file to import
+ * @param threadCount is the number of threads to parse with, 0 for one per online CPU
+ * @return true if the whole file was imported, false on an error or if the callback stopped it
+ */
+bool importGenericDashFile(GenericDashImporter* importer, const char* path, unsigned int threadCount);
+
+#endif // GENERIC_DASH_IMPORT_FILES
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // link_generic_dash_import_h
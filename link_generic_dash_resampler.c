@@ -0,0 +1,141 @@
+/*
+ Any additions to this file will need suitable additions to link_generic_dash_resampler.h
+ For documentation please the above file.
+ */
+
+#include "link_generic_dash_resampler.h"
+
+#include <math.h>
+
+static uint64_t getGenericDashResamplerRowTime(const GenericDashResampler* resampler, uint64_t row) {
+	// Split so epoch timestamps at high rates can't overflow
+	return (row / resampler->rateHz) * 1000000 + (row % resampler->rateHz) * 1000000 / resampler->rateHz;
+}
+
+static void resampleGenericDashFrame(const GenericDashResampler* resampler, int frame, uint64_t rowTime, float* values) {
+	const GenericDashResamplerFrame* samples = &resampler->frames[frame];
+	int first = frame * 3;
+
+	if (samples->count == 0) {
+		for (int i = 0; i < 3; i++) values[first + i] = NAN;
+		return;
+	}
+
+	// Walk back from the newest sample to the last one at or before the row
+	int before = samples->newest;
+	int after = -1;
+	for (int i = 0; i < samples->count - 1 && samples->timestamps[before] > rowTime; i++) {
+		after = before;
+		before = before ? before - 1 : maxGenericDashResamplerHistory - 1;
+	}
+	// Nothing old enough left, hold the oldest sample there is
+	if (samples->timestamps[before] > rowTime) after = -1;
+
+	for (int i = 0; i < 3; i++) {
+		GenericDashParameters param = (GenericDashParameters)(first + i);
+		float value = decodeGenericDashValue(param, samples->words[before][i]);
+		if (after >= 0 && resampler->modes[param] == RESAMPLE_MODE_LINEAR) {
+			float next = decodeGenericDashValue(param, samples->words[after][i]);
+			uint64_t span = samples->timestamps[after] - samples->timestamps[before];
+			value += (next - value) * (float)(rowTime - samples->timestamps[before]) / (float)span;
+		}
+		values[first + i] = value;
+	}
+}
+
+static void emitGenericDashResamplerRow(GenericDashResampler* resampler) {
+	float values[Generic_Dash_Parameter_Count];
+	uint64_t rowTime = getGenericDashResamplerRowTime(resampler, resampler->nextRow);
+
+	for (int i = 0; i < Generic_Dash_Frame_Count; i++) resampleGenericDashFrame(resampler, i, rowTime, values);
+	resampler->nextRow++;
+	resampler->rowsEmitted++;
+	if (resampler->callback != NULL) resampler->callback(resampler, rowTime, values);
+}
+
+bool initGenericDashResampler(GenericDashResampler* resampler, uint32_t rateHz, uint64_t latency, GenericDashResamplerCallback callback, void* user) {
+	if (rateHz == 0 || rateHz > 1000000) return false;
+
+	memset(resampler, 0, sizeof(*resampler));
+	initGenericDashContext(&resampler->context);
+	resampler->rateHz = rateHz;
+	resampler->latency = latency ? latency : defaultGenericDashResamplerLatency;
+	resampler->callback = callback;
+	resampler->user = user;
+
+	for (int i = 0; i < Generic_Dash_Parameter_Count; i++) {
+		switch (i) {
+			case ECU_GEAR_POSITION:
+			case ECU_TRIGGER_1_ERROR_COUNT:
+			case ECU_FAULT_CODE:
+			case ECU_LIMIT_FLAGS_BITFIELD:
+			case ECU_STATUS_BITFIELD:
+				resampler->modes[i] = RESAMPLE_MODE_HOLD;
+				break;
+			default:
+				resampler->modes[i] = RESAMPLE_MODE_LINEAR;
+				break;
+		}
+	}
+	return true;
+}
+
+bool setGenericDashResamplerMode(GenericDashResampler* resampler, GenericDashParameters param, GenericDashResampleModes mode) {
+	if ((int)param < 0 || (int)param >= Generic_Dash_Parameter_Count) return false;
+	if (mode != RESAMPLE_MODE_HOLD && mode != RESAMPLE_MODE_LINEAR) return false;
+	resampler->modes[param] = (unsigned char)mode;
+	return true;
+}
+
+bool pushGenericDashResamplerFrame(GenericDashResampler* resampler, const GenericDashRecord* record) {
+	if (!parseGenericDashContextCanFrame(&resampler->context, record->frame)) return false;
+
+	// Out of order frames are treated as arriving with the latest one
+	uint64_t timestamp = record->timestamp;
+	if (!resampler->started) {
+		resampler->started = true;
+		resampler->nextRow = (timestamp / 1000000) * resampler->rateHz + ((timestamp % 1000000) * resampler->rateHz + 999999) / 1000000;
+		while (getGenericDashResamplerRowTime(resampler, resampler->nextRow) < timestamp) resampler->nextRow++;
+	} else if (timestamp < resampler->clock) {
+		timestamp = resampler->clock;
+	}
+	resampler->clock = timestamp;
+
+	GenericDashResamplerFrame* samples = &resampler->frames[record->frame[0]];
+	if (samples->count == maxGenericDashResamplerHistory) {
+		// The oldest sample is about to go, so emit any row still waiting on it now rather than lose it
+		uint64_t secondOldest = samples->timestamps[(samples->newest + 2) % maxGenericDashResamplerHistory];
+		while (getGenericDashResamplerRowTime(resampler, resampler->nextRow) < secondOldest) {
+			emitGenericDashResamplerRow(resampler);
+			resampler->rowsEarly++;
+		}
+	}
+	if (samples->count) samples->newest = (samples->newest + 1) % maxGenericDashResamplerHistory;
+	if (samples->count < maxGenericDashResamplerHistory) samples->count++;
+	samples->timestamps[samples->newest] = timestamp;
+	memcpy(samples->words[samples->newest], &resampler->context.words[record->frame[0] * 3], sizeof(samples->words[0]));
+
+	// A row is complete once every frame has moved past it, or it has waited long enough
+	uint64_t complete = timestamp;
+	for (int i = 0; i < Generic_Dash_Frame_Count; i++) {
+		const GenericDashResamplerFrame* frame = &resampler->frames[i];
+		if (frame->count == 0) {
+			complete = 0;
+			break;
+		}
+		if (frame->timestamps[frame->newest] < complete) complete = frame->timestamps[frame->newest];
+	}
+
+	for (;;) {
+		uint64_t rowTime = getGenericDashResamplerRowTime(resampler, resampler->nextRow);
+		if (rowTime >= complete && rowTime + resampler->latency > timestamp) break;
+		emitGenericDashResamplerRow(resampler);
+	}
+	return true;
+}
+
+void flushGenericDashResampler(GenericDashResampler* resampler) {
+	if (!resampler->started) return;
+	while (getGenericDashResamplerRowTime(resampler, resampler->nextRow) <= resampler->clock)
+		emitGenericDashResamplerRow(resampler);
+}
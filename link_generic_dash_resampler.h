@@ -0,0 +1,133 @@
+/*
+ link_generic_dash_resampler.h - Resamples a Generic Dash stream onto a fixed timebase
+ For copyright and license information see LICENSE
+
+ Each of the 14 frames arrives at its own time, so the three parameters in one
+ frame are sampled at a different instant to those in the next. The resampler
+ takes timestamped frames and emits rows of every parameter at a fixed rate,
+ ie. exactly every 10 ms for 100 Hz, which is what most analysis tools want.
+
+ Rows are aligned to multiples of the row period from timestamp 0, so streams
+ resampled at the same rate line up with each other. Each parameter is either
+ interpolated linearly between the samples either side of the row, or holds
+ its last sample. Gear, fault code, trigger error count and the bitfields hold
+ by default, everything else is linear.
+
+ Only the last few samples of each frame are kept, so memory use is fixed no
+ matter how long the stream is. A row is emitted as soon as every frame has a
+ sample after it, or once the stream is a set latency past it, whichever is
+ first. Frames should be pushed in timestamp order, any that go back in time
+ are treated as arriving with the latest frame.
+
+ The latency can only be as long as maxGenericDashResamplerHistory - 1
+ periods of the fastest frame, as a row needs the sample before it. If a
+ frame arrives often enough that the sample a waiting row needs would be
+ dropped, the row is emitted early instead and counted in rowsEarly, so a
+ latency that is too long shows up there rather than as held values.
+ */
+
+#ifndef link_generic_dash_resampler_h
+#define link_generic_dash_resampler_h
+
+#include "link_generic_dash.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief Number of samples of each frame kept for interpolation
+ */
+#define maxGenericDashResamplerHistory 8
+
+/**
+ * @brief Default time a row waits for late frames in microseconds
+ */
+#define defaultGenericDashResamplerLatency 50000
+
+/**
+ * @brief How a parameter's value is worked out at a row's timestamp
+ */
+typedef enum {
+	RESAMPLE_MODE_HOLD,   // Last sample at or before the row
+	RESAMPLE_MODE_LINEAR, // Straight line between the samples either side of the row
+} GenericDashResampleModes;
+
+typedef struct GenericDashResampler GenericDashResampler;
+
+/**
+ * @brief Called for every row emitted by a resampler
+ * @param resampler is the resampler emitting the row
+ * @param timestamp is the row's timestamp in microseconds
+ * @param values are all Generic_Dash_Parameter_Count values, NAN for any not yet received
+ */
+typedef void (*GenericDashResamplerCallback)(GenericDashResampler* resampler, uint64_t timestamp, const float values[Generic_Dash_Parameter_Count]);
+
+/**
+ * @brief Ring of the most recent samples of a single frame
+ */
+typedef struct {
+	uint64_t timestamps[maxGenericDashResamplerHistory];
+	uint16_t words[maxGenericDashResamplerHistory][3];
+	unsigned char newest; // Index of the latest sample
+	unsigned char count;
+} GenericDashResamplerFrame;
+
+/**
+ * @brief Streaming resampler state
+ */
+struct GenericDashResampler {
+	unsigned char modes[Generic_Dash_Parameter_Count]; // One of GenericDashResampleModes for each parameter
+	GenericDashResamplerFrame frames[Generic_Dash_Frame_Count];
+	GenericDashContext context; // Latest values, as a decoder fed the same frames would have
+	uint32_t rateHz;
+	uint64_t latency;
+	uint64_t nextRow; // Index of the next row to emit, its timestamp is nextRow * 1000000 / rateHz
+	uint64_t clock;   // Latest timestamp pushed
+	bool started;
+	uint64_t rowsEmitted;
+	uint64_t rowsEarly; // Rows emitted before the latency was up because a frame's history was full
+	GenericDashResamplerCallback callback;
+	void* user; // Anything you like, ie. the file rows are written to
+};
+
+/**
+ * @brief Sets up a resampler with the default mode for every parameter
+ * @param resampler is the resampler to set up
+ * @param rateHz is the number of rows per second to emit
+ * @param latency is how long a row waits for late frames in microseconds, 0 for defaultGenericDashResamplerLatency.
+ * At most maxGenericDashResamplerHistory - 1 periods of the fastest frame, ie. 70 ms for frames at 100 Hz.
+ * @param callback is called for every row emitted
+ * @param user is stored in the resampler for use by the callback
+ * @return true if successful, false otherwise
+ */
+bool initGenericDashResampler(GenericDashResampler* resampler, uint32_t rateHz, uint64_t latency, GenericDashResamplerCallback callback, void* user);
+
+/**
+ * @brief Changes how a parameter is resampled
+ * @param resampler is the resampler to change
+ * @param param is one of enum GenericDashParameters to change
+ * @param mode is one of enum GenericDashResampleModes
+ * @return true if successful, false otherwise
+ */
+bool setGenericDashResamplerMode(GenericDashResampler* resampler, GenericDashParameters param, GenericDashResampleModes mode);
+
+/**
+ * @brief Adds a frame to a resampler, emitting any rows that are now complete
+ * @param resampler is the resampler to add to
+ * @param record is the frame and the time it was received in microseconds
+ * @return true if the frame was valid, false otherwise
+ */
+bool pushGenericDashResamplerFrame(GenericDashResampler* resampler, const GenericDashRecord* record);
+
+/**
+ * @brief Emits every remaining row up to the latest frame pushed, ie. at the end of a log
+ * @param resampler is the resampler to flush
+ */
+void flushGenericDashResampler(GenericDashResampler* resampler);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // link_generic_dash_resampler_h